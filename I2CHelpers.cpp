@@ -58,24 +58,42 @@ byte I2CHelpers::readFromCurrentAddress(int device_address, int bytes_to_read, b
     // this increases the speed of the read operation, by saving the
     // time required to specify the register address
 
-    // request the bytes from the device, sending repeated start
-    //Wire.requestFrom(device_address, bytes_to_read, false);
-    Wire.requestFrom(device_address, bytes_to_read, true);
-
+    // the address pointer auto-increments within the window, so a read
+    // longer than the Wire receive buffer is split into consecutive
+    // current address reads
     int i = 0;
-    byte error = 0;
-    while (Wire.available())
+    while (i < bytes_to_read)
     {
-      if (i >= bytes_to_read)
-      {
-        // if we have more bytes than we requested, return an error
-        error = 6;
-        break;
-      }
-      buf[i] = Wire.read();
-      i++;
+        int chunk = bytes_to_read - i;
+        if (chunk > IQS_I2C_BUFFER_LENGTH)
+        {
+            chunk = IQS_I2C_BUFFER_LENGTH;
+        }
+
+        // request the bytes from the device, sending stop when done
+        //Wire.requestFrom(device_address, chunk, false);
+        Wire.requestFrom(device_address, chunk, true);
+
+        int received = 0;
+        while (Wire.available())
+        {
+          if (received >= chunk)
+          {
+            // if we have more bytes than we requested, return an error
+            return 6;
+          }
+          buf[i + received] = Wire.read();
+          received++;
+        }
+
+        if (received < chunk)
+        {
+            // error code 11: fewer bytes than requested (e.g. NACK)
+            return 11;
+        }
+        i += chunk;
     }
-    return error;
+    return 0;
 }
 
 byte I2CHelpers::readFromRegister(int device_address, int register_address, int bytes_to_read, byte* buf)
@@ -138,6 +156,30 @@ byte I2CHelpers::writeToRegister(int device_address, int register_address, int b
     return error;
 }
 
+byte I2CHelpers::transfer(int device_address, const byte* tx, int tx_length, byte* rx, int rx_length)
+{
+    // write tx_length bytes, then read rx_length bytes after a repeated
+    // start. either part may be empty
+    if (tx_length > 0)
+    {
+        Wire.beginTransmission(device_address);
+        Wire.write(tx, tx_length);
+
+        // only release the bus if nothing is read afterwards
+        byte error = Wire.endTransmission(rx_length == 0);
+        if (error != 0)
+        {
+            return error;
+        }
+    }
+
+    if (rx_length > 0)
+    {
+        return I2CHelpers::readFromCurrentAddress(device_address, rx_length, rx);
+    }
+    return 0;
+}
+
 bool I2CHelpers::getBit(byte b, int bit)
 {
     return (b >> bit) & 1;
@@ -7,6 +7,20 @@
 
 #define END_COMM_REG 0xEEEE
 
+// size of the Wire transmit/receive buffers, which bounds a single transaction
+#ifndef IQS_I2C_BUFFER_LENGTH
+    #if defined(I2C_BUFFER_LENGTH)
+        #define IQS_I2C_BUFFER_LENGTH I2C_BUFFER_LENGTH
+    #elif defined(BUFFER_LENGTH)
+        #define IQS_I2C_BUFFER_LENGTH BUFFER_LENGTH
+    #else
+        #define IQS_I2C_BUFFER_LENGTH 32
+    #endif
+#endif
+
+// the longest register burst that fits in one write (2 address bytes + data)
+#define IQS_MAX_WRITE_BURST (IQS_I2C_BUFFER_LENGTH - 2)
+
 class I2CHelpers
 {
     public:
@@ -18,6 +32,7 @@ class I2CHelpers
         static byte readFromCurrentAddress(int device_address, int bytes_to_read, byte* buf);
         static byte readFromRegister(int device_address, int register_address, int bytes_to_read, byte* buf);
         static byte writeToRegister(int device_address, int register_address, int bytes_to_write, byte* buf);
+        static byte transfer(int device_address, const byte* tx, int tx_length, byte* rx, int rx_length);
         static byte endCommunication(int device_address);
         static bool getBit(byte b, int pos);
 };
@@ -0,0 +1,132 @@
+#include "IQSBus.h"
+#include "I2CHelpers.h"
+
+IQSWireBackend IQSWire;
+
+bool IQSWireBackend::submit(IQSTransaction& transaction)
+{
+    transaction.done = false;
+    transaction.error = I2CHelpers::transfer(transaction.i2cAddress, transaction.tx, transaction.txLength, transaction.rx, transaction.rxLength);
+    transaction.done = true;
+    return true;
+}
+
+#ifdef IQS_HAS_TWIM
+
+IQSTwimBackend::IQSTwimBackend(NRF_TWIM_Type* twim)
+{
+    this->_twim = twim;
+}
+
+bool IQSTwimBackend::submit(IQSTransaction& transaction)
+{
+    if (this->_current != nullptr)
+    {
+        return false;
+    }
+
+    transaction.done = false;
+    transaction.error = 0;
+    this->_current = &transaction;
+
+    NRF_TWIM_Type* twim = this->_twim;
+    twim->ADDRESS = transaction.i2cAddress;
+    twim->EVENTS_STOPPED = 0;
+    twim->EVENTS_ERROR = 0;
+    twim->EVENTS_LASTTX = 0;
+    twim->EVENTS_LASTRX = 0;
+    // error sources are cleared by writing 1
+    twim->ERRORSRC = TWIM_ERRORSRC_ANACK_Msk | TWIM_ERRORSRC_DNACK_Msk | TWIM_ERRORSRC_OVERRUN_Msk;
+
+    twim->TXD.PTR = (uint32_t)(uintptr_t)transaction.tx;
+    twim->TXD.MAXCNT = transaction.txLength;
+    twim->RXD.PTR = (uint32_t)(uintptr_t)transaction.rx;
+    twim->RXD.MAXCNT = transaction.rxLength;
+
+    // chain the phases in hardware: write, repeated start, read, stop
+    if (transaction.txLength > 0 && transaction.rxLength > 0)
+    {
+        twim->SHORTS = TWIM_SHORTS_LASTTX_STARTRX_Msk | TWIM_SHORTS_LASTRX_STOP_Msk;
+        twim->TASKS_STARTTX = 1;
+    }
+    else if (transaction.txLength > 0)
+    {
+        twim->SHORTS = TWIM_SHORTS_LASTTX_STOP_Msk;
+        twim->TASKS_STARTTX = 1;
+    }
+    else
+    {
+        twim->SHORTS = TWIM_SHORTS_LASTRX_STOP_Msk;
+        twim->TASKS_STARTRX = 1;
+    }
+    return true;
+}
+
+void IQSTwimBackend::poll()
+{
+    IQSTransaction* transaction = this->_current;
+    if (transaction == nullptr)
+    {
+        return;
+    }
+
+    NRF_TWIM_Type* twim = this->_twim;
+    if (twim->EVENTS_ERROR)
+    {
+        // a NACK does not trigger the stop shortcut, so stop by hand
+        twim->EVENTS_ERROR = 0;
+        twim->TASKS_STOP = 1;
+    }
+    if (!twim->EVENTS_STOPPED)
+    {
+        return;
+    }
+    twim->EVENTS_STOPPED = 0;
+
+    // map to the Wire error codes
+    uint32_t source = twim->ERRORSRC;
+    twim->ERRORSRC = source;
+    byte error = 0;
+    if (source & TWIM_ERRORSRC_ANACK_Msk)
+    {
+        error = 2;
+    }
+    else if (source & TWIM_ERRORSRC_DNACK_Msk)
+    {
+        error = 3;
+    }
+    else if (source & TWIM_ERRORSRC_OVERRUN_Msk)
+    {
+        error = 4;
+    }
+    else if ((int)twim->RXD.AMOUNT < transaction->rxLength)
+    {
+        error = 11;
+    }
+
+    twim->SHORTS = 0;
+    this->_current = nullptr;
+    transaction->error = error;
+    transaction->done = true;
+}
+
+void IQSTwimBackend::abort(IQSTransaction& transaction)
+{
+    if (this->_current != &transaction)
+    {
+        return;
+    }
+
+    // stop the transfer where it is, without waiting on the device
+    NRF_TWIM_Type* twim = this->_twim;
+    twim->SHORTS = 0;
+    twim->TASKS_STOP = 1;
+    twim->EVENTS_ERROR = 0;
+    twim->EVENTS_STOPPED = 0;
+
+    this->_current = nullptr;
+    transaction.error = 5;
+    transaction.done = true;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef IQSBUS_H
+#define IQSBUS_H
+
+#include <Arduino.h>
+
+// the nRF52 cores expose the TWIM peripheral, whose EasyDMA can run a whole
+// write/repeated start/read transaction without the CPU
+#if defined(NRF52_SERIES) || defined(NRF52) || defined(ARDUINO_ARCH_NRF52)
+#define IQS_HAS_TWIM 1
+#endif
+
+// one I2C transaction: txLength bytes are written (register address and
+// any data), then, if rxLength > 0, rxLength bytes are read after a repeated
+// start. with txLength == 0 it is a current address read
+//
+// the buffers must stay valid until done is set, and on DMA backends they
+// must be in RAM
+struct IQSTransaction
+{
+    byte i2cAddress;
+    const byte* tx;
+    int txLength;
+    byte* rx;
+    int rxLength;
+    // same error codes as I2CHelpers (Wire codes, 11 for a short read),
+    // valid once done is set
+    volatile byte error;
+    volatile bool done;
+};
+
+// runs transactions on a bus, one at a time
+//
+// submit() only starts a transaction. completion is reported through the
+// transaction's done flag, either straight away (blocking backends), from
+// an interrupt, or from poll(). several touchpads may share one backend, in
+// which case submit() refuses new work until the bus is free again
+class IQSBusBackend
+{
+    public:
+        virtual ~IQSBusBackend() {}
+        // start the transaction, returns false if the bus is busy
+        virtual bool submit(IQSTransaction& transaction) = 0;
+        // advance the transaction in flight, for backends that complete by
+        // polling rather than from an interrupt
+        virtual void poll() {}
+        // give up on the transaction if it is still in flight, freeing the
+        // bus. it is then done with a timeout error (5)
+        virtual void abort(IQSTransaction&) {}
+};
+
+// blocking backend on top of Wire, the default
+//
+// submit() runs the whole transaction before returning, so a window runs to
+// completion inside one update() call, as it always has. this is also the
+// backend used on ESP32, whose Arduino core already drives the I2C hardware
+// from an interrupt but only exposes it through the blocking Wire calls
+class IQSWireBackend : public IQSBusBackend
+{
+    public:
+        bool submit(IQSTransaction& transaction) override;
+};
+
+extern IQSWireBackend IQSWire;
+
+#ifdef IQS_HAS_TWIM
+// non-blocking backend driving an nRF52 TWIM instance with EasyDMA
+//
+// it takes over the TWIM that Wire.begin() has already set up (pins,
+// frequency, enable), so Wire must not be used on that instance while a
+// transaction is in flight. the transfer runs from DMA with shortcuts
+// between its phases, and poll() only checks the completion events
+class IQSTwimBackend : public IQSBusBackend
+{
+    private:
+        NRF_TWIM_Type* _twim;
+        IQSTransaction* volatile _current = nullptr;
+
+    public:
+        IQSTwimBackend(NRF_TWIM_Type* twim = NRF_TWIM0);
+        bool submit(IQSTransaction& transaction) override;
+        void poll() override;
+        void abort(IQSTransaction& transaction) override;
+};
+#endif
+
+#endif // IQSBUS_H
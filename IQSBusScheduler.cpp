@@ -0,0 +1,187 @@
+#include "IQSBusScheduler.h"
+#include <algorithm>
+
+IQSBusScheduler::IQSBusScheduler(IQSBusBackend* backend)
+{
+    this->_bus = backend != nullptr ? backend : &IQSWire;
+}
+
+bool IQSBusScheduler::add(IQSTouchpad& touchpad)
+{
+    if (this->_indexOf(touchpad) != -1)
+    {
+        return true;
+    }
+    for (int i = 0; i < IQS_MAX_TOUCHPADS; i++)
+    {
+        if (this->_touchpads[i] == nullptr)
+        {
+            touchpad.setBusBackend(this->_bus);
+            this->_touchpads[i] = &touchpad;
+            this->_stats[i] = IQSServiceStats();
+            return true;
+        }
+    }
+    return false;
+}
+
+void IQSBusScheduler::remove(IQSTouchpad& touchpad)
+{
+    int index = this->_indexOf(touchpad);
+    if (index == -1)
+    {
+        return;
+    }
+    // let a window in flight finish first. a non-blocking backend only
+    // completes it as time passes, so wait a little between updates rather
+    // than spinning on them, for at most one report period (the window's
+    // deadline); a stalled bus or device has its window aborted instead
+    uint32_t start = micros();
+    uint32_t limit = (uint32_t)this->_touchpads[index]->reportRate * 1000;
+    while (this->_active == index)
+    {
+        if (micros() - start >= limit)
+        {
+            this->_touchpads[index]->_abortWindow();
+            this->_active = -1;
+            break;
+        }
+        this->update();
+        if (this->_active == index)
+        {
+            delayMicroseconds(10);
+        }
+    }
+    this->_touchpads[index] = nullptr;
+}
+
+int IQSBusScheduler::_indexOf(const IQSTouchpad& touchpad)
+{
+    for (int i = 0; i < IQS_MAX_TOUCHPADS; i++)
+    {
+        if (this->_touchpads[i] == &touchpad)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int IQSBusScheduler::_oldestReady()
+{
+    int oldest = -1;
+    uint32_t oldestReady = 0;
+    for (int i = 0; i < IQS_MAX_TOUCHPADS; i++)
+    {
+        IQSTouchpad* touchpad = this->_touchpads[i];
+        if (touchpad == nullptr || !touchpad->ready || touchpad->resetInProgress())
+        {
+            continue;
+        }
+        // wrap-safe comparison of the RDY timestamps
+        uint32_t ready = touchpad->readyMicros;
+        if (oldest == -1 || (int32_t)(ready - oldestReady) < 0)
+        {
+            oldest = i;
+            oldestReady = ready;
+        }
+    }
+    return oldest;
+}
+
+void IQSBusScheduler::_start(int index)
+{
+    IQSTouchpad* touchpad = this->_touchpads[index];
+    uint32_t ready = touchpad->readyMicros;
+    uint32_t wait = micros() - ready;
+
+    IQSServiceStats& stats = this->_stats[index];
+    stats.waitMin = std::min(stats.waitMin, wait);
+    stats.waitMax = std::max(stats.waitMax, wait);
+    stats.waitTotal += wait;
+
+    this->_windowReady[index] = ready;
+    this->_active = index;
+    touchpad->update();
+}
+
+void IQSBusScheduler::_finish(int index)
+{
+    IQSTouchpad* touchpad = this->_touchpads[index];
+    uint32_t service = micros() - this->_windowReady[index];
+
+    IQSServiceStats& stats = this->_stats[index];
+    stats.windows++;
+    stats.serviceMin = std::min(stats.serviceMin, service);
+    stats.serviceMax = std::max(stats.serviceMax, service);
+    stats.serviceTotal += service;
+    if (service > (uint32_t)touchpad->reportRate * 1000)
+    {
+        stats.deadlineMisses++;
+    }
+
+    this->_active = -1;
+}
+
+void IQSBusScheduler::update()
+{
+    // touchpads that are not serviced in this call report no new data, and
+    // the ones that are booting can time out
+    for (int i = 0; i < IQS_MAX_TOUCHPADS; i++)
+    {
+        if (this->_touchpads[i] != nullptr && i != this->_active)
+        {
+            this->_touchpads[i]->_wasUpdated = false;
+            this->_touchpads[i]->_numEvents = 0;
+            this->_touchpads[i]->_updateReset();
+        }
+    }
+
+    // continue the window in flight
+    if (this->_active != -1)
+    {
+        int index = this->_active;
+        this->_touchpads[index]->update();
+        if (this->_touchpads[index]->windowInProgress())
+        {
+            return;
+        }
+        this->_finish(index);
+    }
+
+    // start windows oldest RDY first while the bus is free. each touchpad
+    // is started at most once per call, so a pad whose next window opens
+    // while others are serviced waits for the next call
+    bool started[IQS_MAX_TOUCHPADS] = {};
+    while (true)
+    {
+        int index = this->_oldestReady();
+        if (index == -1 || started[index])
+        {
+            return;
+        }
+        started[index] = true;
+
+        this->_start(index);
+        if (this->_touchpads[index]->windowInProgress())
+        {
+            return;
+        }
+        this->_finish(index);
+    }
+}
+
+const IQSServiceStats& IQSBusScheduler::stats(const IQSTouchpad& touchpad)
+{
+    static const IQSServiceStats empty;
+    int index = this->_indexOf(touchpad);
+    return index != -1 ? this->_stats[index] : empty;
+}
+
+void IQSBusScheduler::resetStats()
+{
+    for (int i = 0; i < IQS_MAX_TOUCHPADS; i++)
+    {
+        this->_stats[i] = IQSServiceStats();
+    }
+}
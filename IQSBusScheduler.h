@@ -0,0 +1,74 @@
+#ifndef IQSBUSSCHEDULER_H
+#define IQSBUSSCHEDULER_H
+
+#include "IQSTouchpad.h"
+#include "IQSBus.h"
+#include <Arduino.h>
+
+// service statistics of one device, in microseconds
+struct IQSServiceStats
+{
+    // windows serviced, and those that ended after their deadline
+    uint32_t windows = 0;
+    uint32_t deadlineMisses = 0;
+
+    // RDY edge to the start of the window (time spent waiting for the bus)
+    uint32_t waitMin = 0xFFFFFFFF;
+    uint32_t waitMax = 0;
+    uint64_t waitTotal = 0;
+
+    // RDY edge to the end of the window
+    uint32_t serviceMin = 0xFFFFFFFF;
+    uint32_t serviceMax = 0;
+    uint64_t serviceTotal = 0;
+
+    uint32_t waitMean() const { return windows ? waitTotal / windows : 0; }
+    uint32_t serviceMean() const { return windows ? serviceTotal / windows : 0; }
+};
+
+// owns a bus shared by several touchpads and decides whose window runs
+//
+// call the scheduler's update() from loop() instead of each touchpad's. it
+// runs one window at a time on the shared backend, picking the touchpad
+// whose RDY edge is oldest, so a pad is never starved by one that keeps
+// becoming ready. each window has a deadline of one report period (the
+// touchpad's active mode report rate) after its RDY edge, by which the next
+// cycle is due; windows that end later are counted as deadline misses
+//
+// with a blocking backend every ready touchpad is serviced (oldest first)
+// inside one update() call; with a non-blocking backend update() returns
+// as soon as the current window is waiting on the bus
+class IQSBusScheduler
+{
+    private:
+        IQSBusBackend* _bus;
+        IQSTouchpad* _touchpads[IQS_MAX_TOUCHPADS] = {};
+        IQSServiceStats _stats[IQS_MAX_TOUCHPADS];
+        // RDY edge of the window in flight on each touchpad
+        uint32_t _windowReady[IQS_MAX_TOUCHPADS] = {};
+        // index of the touchpad whose window is in flight, -1 if none
+        int _active = -1;
+
+        int _indexOf(const IQSTouchpad& touchpad);
+        int _oldestReady();
+        void _start(int index);
+        void _finish(int index);
+
+    public:
+        // nullptr uses Wire
+        IQSBusScheduler(IQSBusBackend* backend = nullptr);
+
+        // returns false if IQS_MAX_TOUCHPADS touchpads are already scheduled
+        bool add(IQSTouchpad& touchpad);
+        // waits for a window in flight on the touchpad to end first, for up
+        // to one report period, after which the window is aborted
+        void remove(IQSTouchpad& touchpad);
+
+        void update();
+
+        // stats of a scheduled touchpad (empty stats if it is not scheduled)
+        const IQSServiceStats& stats(const IQSTouchpad& touchpad);
+        void resetStats();
+};
+
+#endif // IQSBUSSCHEDULER_H
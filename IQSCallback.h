@@ -0,0 +1,153 @@
+#ifndef IQSCALLBACK_H
+#define IQSCALLBACK_H
+
+#include <stddef.h>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+// bytes of inline storage available to a callback's captures. a callable
+// that does not fit is a compile error rather than a heap allocation
+#ifndef IQS_CALLBACK_STORAGE
+#define IQS_CALLBACK_STORAGE (4 * sizeof(void*))
+#endif
+
+template <typename Signature, size_t Storage = IQS_CALLBACK_STORAGE>
+class IQSCallback;
+
+// non-allocating replacement for std::function
+//
+// the callable (lambda, functor or function pointer) is stored inline and
+// called through a single function pointer, so constructing, copying and
+// invoking never touch the heap. calling an empty callback does nothing and
+// returns a value-initialised result
+template <typename R, typename... Args, size_t Storage>
+class IQSCallback<R(Args...), Storage>
+{
+    private:
+        enum Operation { COPY, MOVE, DESTROY };
+
+        typename std::aligned_storage<Storage, alignof(void*)>::type _storage;
+        R (*_invoke)(const void*, Args...) = nullptr;
+        void (*_manage)(Operation, void*, void*) = nullptr;
+
+        template <typename F>
+        static R _invokeImpl(const void* storage, Args... args)
+        {
+            return (*static_cast<F*>(const_cast<void*>(storage)))(std::forward<Args>(args)...);
+        }
+
+        template <typename F>
+        static void _manageImpl(Operation operation, void* destination, void* source)
+        {
+            switch (operation)
+            {
+                case COPY:
+                    new (destination) F(*static_cast<const F*>(source));
+                    break;
+                case MOVE:
+                    new (destination) F(std::move(*static_cast<F*>(source)));
+                    break;
+                case DESTROY:
+                    static_cast<F*>(destination)->~F();
+                    break;
+            }
+        }
+
+        void _reset()
+        {
+            if (_manage != nullptr)
+            {
+                _manage(DESTROY, &_storage, nullptr);
+            }
+            _invoke = nullptr;
+            _manage = nullptr;
+        }
+
+    public:
+        IQSCallback() {}
+        IQSCallback(std::nullptr_t) {}
+
+        template <typename F,
+                  typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, IQSCallback>::value>::type>
+        IQSCallback(F&& callable)
+        {
+            typedef typename std::decay<F>::type Callable;
+            static_assert(sizeof(Callable) <= Storage, "callable does not fit in IQSCallback, capture less or raise IQS_CALLBACK_STORAGE");
+            static_assert(alignof(Callable) <= alignof(void*), "callable is over-aligned for IQSCallback");
+            new (&_storage) Callable(std::forward<F>(callable));
+            _invoke = &_invokeImpl<Callable>;
+            _manage = &_manageImpl<Callable>;
+        }
+
+        IQSCallback(const IQSCallback& other)
+        {
+            if (other._manage != nullptr)
+            {
+                other._manage(COPY, &_storage, const_cast<void*>(static_cast<const void*>(&other._storage)));
+            }
+            _invoke = other._invoke;
+            _manage = other._manage;
+        }
+
+        IQSCallback(IQSCallback&& other)
+        {
+            if (other._manage != nullptr)
+            {
+                other._manage(MOVE, &_storage, &other._storage);
+            }
+            _invoke = other._invoke;
+            _manage = other._manage;
+        }
+
+        ~IQSCallback()
+        {
+            _reset();
+        }
+
+        IQSCallback& operator=(const IQSCallback& other)
+        {
+            if (this != &other)
+            {
+                _reset();
+                if (other._manage != nullptr)
+                {
+                    other._manage(COPY, &_storage, const_cast<void*>(static_cast<const void*>(&other._storage)));
+                }
+                _invoke = other._invoke;
+                _manage = other._manage;
+            }
+            return *this;
+        }
+
+        IQSCallback& operator=(IQSCallback&& other)
+        {
+            if (this != &other)
+            {
+                _reset();
+                if (other._manage != nullptr)
+                {
+                    other._manage(MOVE, &_storage, &other._storage);
+                }
+                _invoke = other._invoke;
+                _manage = other._manage;
+            }
+            return *this;
+        }
+
+        explicit operator bool() const
+        {
+            return _invoke != nullptr;
+        }
+
+        R operator()(Args... args) const
+        {
+            if (_invoke == nullptr)
+            {
+                return R();
+            }
+            return _invoke(&_storage, std::forward<Args>(args)...);
+        }
+};
+
+#endif // IQSCALLBACK_H
@@ -0,0 +1,407 @@
+#include "IQSCapture.h"
+#include "IQSTouchpad.h"
+#include <string.h>
+
+IQSCaptureWriter::IQSCaptureWriter(Print& out) : _out(out)
+{
+}
+
+void IQSCaptureWriter::_byte(byte value)
+{
+    this->_bytesWritten += this->_out.write(value);
+}
+
+void IQSCaptureWriter::_varint(uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        this->_byte((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    this->_byte(value);
+}
+
+void IQSCaptureWriter::_signed(int32_t value)
+{
+    this->_varint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+void IQSCaptureWriter::_begin()
+{
+    if (this->_started)
+    {
+        return;
+    }
+    this->_started = true;
+    this->_byte('I');
+    this->_byte('Q');
+    this->_byte('S');
+    this->_byte('C');
+    this->_byte(IQS_CAPTURE_VERSION);
+}
+
+void IQSCaptureWriter::frame(uint32_t readyMicros, const byte* block, int length)
+{
+    this->_begin();
+    if (length > IQS_CAPTURE_MAX_FRAME)
+    {
+        length = IQS_CAPTURE_MAX_FRAME;
+    }
+    uint32_t delta = readyMicros - this->_previousMicros;
+    this->_previousMicros = readyMicros;
+
+    // idle frames (nothing changed) only cost their timestamp
+    if (length == this->_previousLength && memcmp(block, this->_previous, length) == 0)
+    {
+        this->_repeatDeltas[this->_repeatCount++] = delta;
+        if (this->_repeatCount == IQS_CAPTURE_MAX_REPEAT)
+        {
+            this->flush();
+        }
+        return;
+    }
+    this->flush();
+
+    this->_byte(IQS_CAPTURE_FRAME);
+    this->_varint(delta);
+    this->_varint(length);
+
+    // runs of unchanged (zero after the XOR) and changed bytes
+    byte delta_bytes[IQS_CAPTURE_MAX_FRAME];
+    for (int i = 0; i < length; i++)
+    {
+        delta_bytes[i] = block[i] ^ (i < this->_previousLength ? this->_previous[i] : 0);
+    }
+    int i = 0;
+    while (i < length)
+    {
+        int run = 1;
+        bool zeros = delta_bytes[i] == 0;
+        while (i + run < length && run < 128 && (delta_bytes[i + run] == 0) == zeros)
+        {
+            run++;
+        }
+        if (zeros)
+        {
+            this->_byte(0x80 | (run - 1));
+        }
+        else
+        {
+            this->_byte(run - 1);
+            for (int j = 0; j < run; j++)
+            {
+                this->_byte(delta_bytes[i + j]);
+            }
+        }
+        i += run;
+    }
+
+    memcpy(this->_previous, block, length);
+    this->_previousLength = length;
+}
+
+void IQSCaptureWriter::read(int address, int numBytes, int value, byte error)
+{
+    this->_begin();
+    this->flush();
+    this->_byte(IQS_CAPTURE_READ);
+    this->_varint(address);
+    this->_varint(numBytes);
+    this->_signed(value);
+    this->_byte(error);
+}
+
+void IQSCaptureWriter::write(int address, int value, byte error)
+{
+    this->_begin();
+    this->flush();
+    this->_byte(IQS_CAPTURE_WRITE);
+    this->_varint(address);
+    this->_signed(value);
+    this->_byte(error);
+}
+
+void IQSCaptureWriter::flush()
+{
+    if (this->_repeatCount == 0)
+    {
+        return;
+    }
+    this->_byte(IQS_CAPTURE_REPEAT);
+    this->_varint(this->_repeatCount);
+    for (int i = 0; i < this->_repeatCount; i++)
+    {
+        this->_varint(this->_repeatDeltas[i]);
+    }
+    this->_repeatCount = 0;
+}
+
+IQSCaptureReader::IQSCaptureReader(const byte* data, size_t length)
+{
+    this->_data = data;
+    this->_length = length;
+}
+
+void IQSCaptureReader::rewind()
+{
+    *this = IQSCaptureReader(this->_data, this->_length);
+}
+
+bool IQSCaptureReader::_byte(byte& value)
+{
+    if (this->_offset >= this->_length)
+    {
+        return false;
+    }
+    value = this->_data[this->_offset++];
+    return true;
+}
+
+bool IQSCaptureReader::_varint(uint32_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        byte b;
+        if (!this->_byte(b))
+        {
+            return false;
+        }
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool IQSCaptureReader::_signed(int32_t& value)
+{
+    uint32_t zigzag;
+    if (!this->_varint(zigzag))
+    {
+        return false;
+    }
+    value = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+    return true;
+}
+
+IQSCaptureRecord IQSCaptureReader::_fail()
+{
+    this->_failed = true;
+    return CAPTURE_ERROR;
+}
+
+IQSCaptureRecord IQSCaptureReader::next()
+{
+    if (this->_failed)
+    {
+        return CAPTURE_ERROR;
+    }
+
+    if (this->_offset == 0)
+    {
+        byte header[5];
+        for (int i = 0; i < 5; i++)
+        {
+            if (!this->_byte(header[i]))
+            {
+                return this->_fail();
+            }
+        }
+        if (memcmp(header, "IQSC", 4) != 0 || header[4] != IQS_CAPTURE_VERSION)
+        {
+            return this->_fail();
+        }
+    }
+
+    uint32_t delta;
+    if (this->_repeatLeft > 0)
+    {
+        // the frame stays as it was, only time moves on
+        this->_repeatLeft--;
+        if (!this->_varint(delta))
+        {
+            return this->_fail();
+        }
+        this->_micros += delta;
+        return CAPTURE_FRAME;
+    }
+
+    byte tag;
+    if (!this->_byte(tag))
+    {
+        return CAPTURE_END;
+    }
+
+    uint32_t address;
+    uint32_t count;
+    int32_t value;
+    switch (tag)
+    {
+        case IQS_CAPTURE_FRAME:
+        {
+            uint32_t length;
+            if (!this->_varint(delta) || !this->_varint(length) || length > IQS_CAPTURE_MAX_FRAME)
+            {
+                return this->_fail();
+            }
+            this->_micros += delta;
+            for (uint32_t i = length; i < (uint32_t)this->_frameLength; i++)
+            {
+                this->_frame[i] = 0;
+            }
+            uint32_t i = 0;
+            while (i < length)
+            {
+                byte control;
+                if (!this->_byte(control))
+                {
+                    return this->_fail();
+                }
+                uint32_t run = (control & 0x7F) + 1;
+                if (i + run > length)
+                {
+                    return this->_fail();
+                }
+                if (control & 0x80)
+                {
+                    // unchanged bytes
+                    i += run;
+                    continue;
+                }
+                for (uint32_t j = 0; j < run; j++, i++)
+                {
+                    byte b;
+                    if (!this->_byte(b))
+                    {
+                        return this->_fail();
+                    }
+                    this->_frame[i] ^= b;
+                }
+            }
+            this->_frameLength = length;
+            return CAPTURE_FRAME;
+        }
+        case IQS_CAPTURE_REPEAT:
+            if (!this->_varint(count) || count == 0)
+            {
+                return this->_fail();
+            }
+            this->_repeatLeft = count;
+            return this->next();
+        case IQS_CAPTURE_READ:
+        {
+            uint32_t numBytes;
+            byte error;
+            if (!this->_varint(address) || !this->_varint(numBytes) || !this->_signed(value) || !this->_byte(error))
+            {
+                return this->_fail();
+            }
+            this->_address = address;
+            this->_numBytes = numBytes;
+            this->_value = value;
+            this->_error = error;
+            return CAPTURE_READ;
+        }
+        case IQS_CAPTURE_WRITE:
+        {
+            byte error;
+            if (!this->_varint(address) || !this->_signed(value) || !this->_byte(error))
+            {
+                return this->_fail();
+            }
+            this->_address = address;
+            this->_numBytes = 0;
+            this->_value = value;
+            this->_error = error;
+            return CAPTURE_WRITE;
+        }
+        default:
+            return this->_fail();
+    }
+}
+
+IQSReplay::IQSReplay(IQSCaptureReader& reader, bool realTime) : _reader(reader)
+{
+    this->_realTime = realTime;
+}
+
+bool IQSReplay::step(IQSTouchpad& touchpad)
+{
+    IQSCaptureRecord record;
+    while ((record = this->_reader.next()) != CAPTURE_FRAME)
+    {
+        if (record != CAPTURE_READ && record != CAPTURE_WRITE)
+        {
+            return false;
+        }
+        this->_operations++;
+    }
+
+    uint32_t ready = this->_reader.readyMicros();
+    if (!this->_started)
+    {
+        this->_started = true;
+        this->_firstMicros = ready;
+        this->_startMicros = micros();
+    }
+    if (this->_realTime)
+    {
+        // hold the frame back to the captured pace, and give it a local timestamp
+        ready = this->_startMicros + (ready - this->_firstMicros);
+        int32_t wait = ready - micros();
+        if (wait >= 1000)
+        {
+            delay(wait / 1000);
+            wait = ready - micros();
+        }
+        if (wait > 0)
+        {
+            delayMicroseconds(wait);
+        }
+    }
+
+    touchpad.setBusBackend(this);
+    // a touchpad that has not been initialized spends its first window on
+    // the pending writes, the frame goes into the next one
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        this->_frameOffset = 0;
+        touchpad._readyMicros = ready;
+        touchpad._ready = true;
+        touchpad.update();
+        while (touchpad.windowInProgress())
+        {
+            touchpad.update();
+        }
+        if (touchpad.wasUpdated)
+        {
+            break;
+        }
+    }
+    this->_frames++;
+    return true;
+}
+
+bool IQSReplay::submit(IQSTransaction& transaction)
+{
+    if (transaction.txLength == 0 && transaction.rxLength > 0)
+    {
+        // the frame read (and any continuation), past the captured block is zero
+        for (int i = 0; i < transaction.rxLength; i++)
+        {
+            int index = this->_frameOffset + i;
+            transaction.rx[i] = index < this->_reader.frameLength() ? this->_reader.frame()[index] : 0;
+        }
+        this->_frameOffset += transaction.rxLength;
+    }
+    else if (transaction.rxLength > 0)
+    {
+        memset(transaction.rx, 0, transaction.rxLength);
+    }
+    transaction.error = 0;
+    transaction.done = true;
+    return true;
+}
@@ -0,0 +1,157 @@
+#ifndef IQSCAPTURE_H
+#define IQSCAPTURE_H
+
+#include "IQSBus.h"
+#include <Arduino.h>
+
+// capture and replay of the raw communication windows
+//
+// a capture holds, in order, every frame block read from the chip (the
+// 9 + 7 * fingers bytes from 0x000D) with the RDY timestamp of its window,
+// and the results of the queued reads and writes. replaying it through
+// IQSReplay runs the frames through the unchanged window, decode, event,
+// filter and frame ring code, as fast as possible or at the captured pace
+//
+// format: the bytes "IQSC" and a version byte, then records of a tag byte
+// and its fields. numbers are LEB128 varints, signed ones zigzag encoded
+// - IQS_CAPTURE_FRAME: RDY time since the previous frame (us), block
+//   length, then the block XOR the previous block (zero padded), as runs:
+//   a control byte c >= 0x80 stands for (c & 0x7F) + 1 zero bytes, c < 0x80
+//   is followed by c + 1 literal bytes
+// - IQS_CAPTURE_REPEAT: a count, then that many RDY times since the
+//   previous frame, of frames identical to the previous one (idle frames)
+// - IQS_CAPTURE_READ: register address, number of bytes, value (signed),
+//   error code
+// - IQS_CAPTURE_WRITE: register address, value (signed), error code
+#define IQS_CAPTURE_VERSION 1
+#define IQS_CAPTURE_FRAME 0x01
+#define IQS_CAPTURE_REPEAT 0x02
+#define IQS_CAPTURE_READ 0x03
+#define IQS_CAPTURE_WRITE 0x04
+
+// largest frame block: 9 bytes of header and 5 fingers of 7 bytes
+#define IQS_CAPTURE_MAX_FRAME 44
+
+// identical frames held back before a repeat record is written
+#ifndef IQS_CAPTURE_MAX_REPEAT
+#define IQS_CAPTURE_MAX_REPEAT 32
+#endif
+
+// encodes a capture into any Print (Serial, a File, a buffer)
+class IQSCaptureWriter
+{
+    private:
+        Print& _out;
+        bool _started = false;
+        byte _previous[IQS_CAPTURE_MAX_FRAME] = {};
+        int _previousLength = 0;
+        uint32_t _previousMicros = 0;
+        // idle frames not written yet
+        uint32_t _repeatDeltas[IQS_CAPTURE_MAX_REPEAT];
+        int _repeatCount = 0;
+        uint32_t _bytesWritten = 0;
+
+        void _byte(byte value);
+        void _varint(uint32_t value);
+        void _signed(int32_t value);
+        void _begin();
+
+    public:
+        IQSCaptureWriter(Print& out);
+
+        void frame(uint32_t readyMicros, const byte* block, int length);
+        void read(int address, int numBytes, int value, byte error);
+        void write(int address, int value, byte error);
+        // write out held back idle frames, e.g. before closing a file
+        void flush();
+
+        const uint32_t& bytesWritten = _bytesWritten;
+};
+
+enum IQSCaptureRecord
+{
+    CAPTURE_END,
+    CAPTURE_FRAME,
+    CAPTURE_READ,
+    CAPTURE_WRITE,
+    // not a capture, or cut off mid record
+    CAPTURE_ERROR,
+};
+
+// decodes a capture held in memory
+class IQSCaptureReader
+{
+    private:
+        const byte* _data;
+        size_t _length;
+        size_t _offset = 0;
+        bool _failed = false;
+        int _repeatLeft = 0;
+
+        byte _frame[IQS_CAPTURE_MAX_FRAME] = {};
+        int _frameLength = 0;
+        uint32_t _micros = 0;
+        int _address = 0;
+        int _numBytes = 0;
+        int _value = 0;
+        byte _error = 0;
+
+        bool _byte(byte& value);
+        bool _varint(uint32_t& value);
+        bool _signed(int32_t& value);
+        IQSCaptureRecord _fail();
+
+    public:
+        IQSCaptureReader(const byte* data, size_t length);
+        void rewind();
+
+        // decode the next record, whose fields are then available below
+        IQSCaptureRecord next();
+
+        // CAPTURE_FRAME
+        const byte* frame() const { return _frame; }
+        int frameLength() const { return _frameLength; }
+        uint32_t readyMicros() const { return _micros; }
+        // CAPTURE_READ / CAPTURE_WRITE (numBytes for reads only)
+        int address() const { return _address; }
+        int numBytes() const { return _numBytes; }
+        int value() const { return _value; }
+        byte error() const { return _error; }
+};
+
+class IQSTouchpad;
+
+// replays a capture into a touchpad, standing in as its bus
+//
+// each step() opens one window on the touchpad, with the captured RDY
+// timestamp, and answers its frame read with the captured block. other
+// transactions succeed (reads return zeros), so queued requests and their
+// callbacks run as usual. captured read/write results are skipped over and
+// counted. the touchpad does not need begin(); with realTime each frame is
+// held back until as much time has passed as in the capture
+class IQSReplay : public IQSBusBackend
+{
+    private:
+        IQSCaptureReader& _reader;
+        bool _realTime;
+        bool _started = false;
+        uint32_t _firstMicros = 0;
+        uint32_t _startMicros = 0;
+        int _frameOffset = 0;
+        uint32_t _frames = 0;
+        uint32_t _operations = 0;
+
+    public:
+        IQSReplay(IQSCaptureReader& reader, bool realTime = false);
+
+        // run the next captured frame through touchpad.update(), false at
+        // the end of the capture
+        bool step(IQSTouchpad& touchpad);
+
+        bool submit(IQSTransaction& transaction) override;
+
+        const uint32_t& frames = _frames;
+        const uint32_t& operations = _operations;
+};
+
+#endif // IQSCAPTURE_H
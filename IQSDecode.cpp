@@ -0,0 +1,42 @@
+#include "IQSDecode.h"
+
+// the 9 byte header, returns the number of contacts to decode
+static int decodeHeader(const byte* block, int length, IQSRawFrame& out)
+{
+    out.gestures = block[0] | (block[1] << 8);
+    out.systemInfo0 = block[2];
+    out.systemInfo1 = block[3];
+    out.numFingers = block[4];
+    // bytes 5 to 8 are the relative X and Y of finger 1, which Finger
+    // works out from the absolute positions
+
+    int slots = length < 9 ? 0 : (length - 9) / 7;
+    int count = out.numFingers;
+    count = count < 5 ? count : 5;
+    count = count < slots ? count : slots;
+    count = (out.systemInfo1 & IQS_SYSTEM_TOO_MANY_FINGERS) ? 0 : count;
+    out.count = count;
+
+    for (int i = count; i < 5; i++)
+    {
+        out.x[i] = 0;
+        out.y[i] = 0;
+        out.strength[i] = 0;
+        out.area[i] = 0;
+    }
+    return count;
+}
+
+void IQSDecode::frame(const byte* block, int length, IQSRawFrame& out)
+{
+    int count = decodeHeader(block, length, out);
+    // 7 bytes per finger: X, Y and strength big-endian, then area
+    for (int i = 0; i < count; i++)
+    {
+        const byte* slot = block + 9 + 7 * i;
+        out.x[i] = (slot[0] << 8) | slot[1];
+        out.y[i] = (slot[2] << 8) | slot[3];
+        out.strength[i] = (slot[4] << 8) | slot[5];
+        out.area[i] = slot[6];
+    }
+}
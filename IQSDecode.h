@@ -0,0 +1,47 @@
+#ifndef IQSDECODE_H
+#define IQSDECODE_H
+
+#include <stdint.h>
+#include <Arduino.h>
+
+// system info 0 (0x000F): the chip has reset and not been acknowledged since
+#define IQS_SYSTEM_SHOW_RESET (1 << 7)
+
+// system info 1 (0x0010) bits, as kept in IQSRawFrame::systemInfo1
+#define IQS_SYSTEM_TP_MOVEMENT (1 << 0)
+#define IQS_SYSTEM_PALM_DETECT (1 << 1)
+#define IQS_SYSTEM_TOO_MANY_FINGERS (1 << 2)
+#define IQS_SYSTEM_RR_MISSED (1 << 3)
+#define IQS_SYSTEM_SNAP_TOGGLE (1 << 4)
+#define IQS_SYSTEM_SWITCH_STATE (1 << 5)
+
+// one frame block (the 9 + 7 * fingers bytes from 0x000D), decoded
+struct IQSRawFrame
+{
+    // single finger gestures | multi finger gestures << 8, see the
+    // IQS_GESTURE_* bits in IQSEvents.h
+    uint16_t gestures;
+    uint8_t systemInfo0;
+    // see the IQS_SYSTEM_* bits
+    uint8_t systemInfo1;
+    // as reported by the chip
+    uint8_t numFingers;
+    // contacts decoded: numFingers, but at most 5 and at most the finger
+    // slots present in the block, and 0 with TOO_MANY_FINGERS. slots from
+    // count on are zero
+    uint8_t count;
+    uint16_t x[5];
+    uint16_t y[5];
+    uint16_t strength[5];
+    uint8_t area[5];
+};
+
+class IQSDecode
+{
+    public:
+        // decode block (length bytes, a short block has fewer finger slots)
+        // into out
+        static void frame(const byte* block, int length, IQSRawFrame& out);
+};
+
+#endif // IQSDECODE_H
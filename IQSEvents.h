@@ -0,0 +1,64 @@
+#ifndef IQSEVENTS_H
+#define IQSEVENTS_H
+
+#include <stdint.h>
+#include "IQSCallback.h"
+#include <Arduino.h>
+
+class IQSTouchpad;
+
+// maximum number of events produced by one frame: down/move/up for each of
+// the 5 fingers (up and down for a slot that changed hands) plus one per
+// gesture bit, as far as there is room
+#define IQS_MAX_FRAME_EVENTS 16
+
+// maximum number of onFrame subscribers per touchpad
+#ifndef IQS_MAX_FRAME_SUBSCRIBERS
+#define IQS_MAX_FRAME_SUBSCRIBERS 4
+#endif
+
+enum IQSTouchEventType
+{
+    FINGER_DOWN,
+    FINGER_MOVE,
+    FINGER_UP,
+    GESTURE,
+};
+
+// bits of IQSTouchEvent::changed, one per finger field that differs from
+// the previous frame
+#define IQS_CHANGED_X (1 << 0)
+#define IQS_CHANGED_Y (1 << 1)
+#define IQS_CHANGED_FORCE (1 << 2)
+#define IQS_CHANGED_AREA (1 << 3)
+
+// bits of IQSTouchEvent::gesture: the single finger gesture byte (0x000D) in
+// the low byte and the multi finger gesture byte (0x000E) in the high byte
+#define IQS_GESTURE_TAP (1 << 0)
+#define IQS_GESTURE_PRESS_AND_HOLD (1 << 1)
+#define IQS_GESTURE_SWIPE_X_POS (1 << 2)
+#define IQS_GESTURE_SWIPE_X_NEG (1 << 3)
+#define IQS_GESTURE_SWIPE_Y_POS (1 << 4)
+#define IQS_GESTURE_SWIPE_Y_NEG (1 << 5)
+#define IQS_GESTURE_TWO_FINGER_TAP (1 << 8)
+#define IQS_GESTURE_SCROLL (1 << 9)
+#define IQS_GESTURE_ZOOM (1 << 10)
+
+struct IQSTouchEvent
+{
+    uint8_t type;     // IQSTouchEventType
+    uint8_t finger;   // finger index, unused for GESTURE
+    uint8_t changed;  // IQS_CHANGED_* mask (all set for FINGER_DOWN)
+    uint8_t area;
+    uint16_t x;
+    uint16_t y;
+    uint16_t force;
+    uint16_t gesture; // the IQS_GESTURE_* bit that was raised, for GESTURE
+};
+
+// called once per communication window that changed something, with that
+// frame's events. runs in whichever task calls update(), after the window
+// has been closed
+typedef IQSCallback<void(IQSTouchpad&, const IQSTouchEvent*, int)> IQSFrameCallback;
+
+#endif // IQSEVENTS_H
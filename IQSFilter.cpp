@@ -0,0 +1,78 @@
+#include "IQSFilter.h"
+
+namespace
+{
+    // estimates of a jumpy finger can exceed 32 bits for a moment
+    int32_t saturate(int64_t value)
+    {
+        if (value > INT32_MAX) { return INT32_MAX; }
+        if (value < INT32_MIN) { return INT32_MIN; }
+        return (int32_t)value;
+    }
+}
+
+int32_t IQSAxisFilter::alpha(uint32_t cutoff, uint32_t dtMicros)
+{
+    // alpha = r / (1 + r) with r = 2 pi fc dt, where 2 pi * 65536 = 411775
+    int64_t r = (int64_t)cutoff * dtMicros * 411775 / 1000000000;
+    return (int32_t)((r << 16) / (65536 + r));
+}
+
+int IQSAxisFilter::apply(const IQSFilterConfig& config, int value, uint32_t dtMicros, int resolution)
+{
+    int32_t sample = value << 8;
+    // a contact that paused for longer than this is treated as a new one
+    if (!this->_primed || dtMicros == 0 || dtMicros > 200000)
+    {
+        // the first sample of a contact passes through and seeds the state
+        this->_primed = true;
+        this->_position = sample;
+        this->_speed = 0;
+        this->_velocity = 0;
+        this->_acceleration = 0;
+        return value;
+    }
+
+    int32_t previous = this->_position;
+    int32_t derivativeAlpha = IQSAxisFilter::alpha(config.derivativeCutoff, dtMicros);
+
+    if (config.stages & IQS_FILTER_JITTER)
+    {
+        // 1 euro filter: the cutoff rises with the (smoothed) speed
+        int32_t speed = saturate((int64_t)(sample - previous) * 1000000 / dtMicros);
+        this->_speed = saturate(this->_speed + (((int64_t)speed - this->_speed) * derivativeAlpha >> 16));
+        int64_t absoluteSpeed = this->_speed < 0 ? -(int64_t)this->_speed : this->_speed;
+        int64_t cutoff = config.minCutoff + ((config.beta * absoluteSpeed * 1000) >> 24);
+        // beyond 1 kHz the filter is transparent anyway
+        if (cutoff > 1000000) { cutoff = 1000000; }
+        int32_t positionAlpha = IQSAxisFilter::alpha((uint32_t)cutoff, dtMicros);
+        this->_position += (int32_t)(((int64_t)(sample - previous) * positionAlpha) >> 16);
+    }
+    else
+    {
+        this->_position = sample;
+    }
+
+    int64_t output = this->_position;
+    if (config.stages & IQS_FILTER_PREDICT)
+    {
+        // smoothed velocity and acceleration of the (filtered) position
+        int32_t velocity = saturate((int64_t)(this->_position - previous) * 1000000 / dtMicros);
+        int32_t acceleration = saturate((int64_t)(velocity - this->_velocity) * 1000000 / dtMicros);
+        this->_velocity = saturate(this->_velocity + (((int64_t)velocity - this->_velocity) * derivativeAlpha >> 16));
+        this->_acceleration = saturate(this->_acceleration + (((int64_t)acceleration - this->_acceleration) * derivativeAlpha >> 16));
+
+        // x + v t + a t^2 / 2. a * t * t would overflow 64 bits past a lead
+        // of about 65 ms, so take a * t first, and keep t within a second
+        int64_t lead = config.leadMicros < 1000000 ? config.leadMicros : 1000000;
+        output += (int64_t)this->_velocity * lead / 1000000;
+        output += (int64_t)this->_acceleration * lead / 1000000 * lead / 2000000;
+    }
+
+    // round back to whole coordinates. extrapolating a flick can overshoot
+    // the edge of the pad, which is as far as a finger can get
+    output = (output + 128) >> 8;
+    int64_t maximum = resolution > 0 ? resolution - 1 : 0xFFFF;
+    if (output > maximum) { output = maximum; }
+    return output < 0 ? 0 : (int)output;
+}
@@ -0,0 +1,49 @@
+#ifndef IQSFILTER_H
+#define IQSFILTER_H
+
+#include <stdint.h>
+
+// stages of the finger coordinate filter, see IQSTouchpad::setFilter
+// adaptive low-pass (1 euro filter): smooths a still finger hard and a
+// moving one barely, so jitter goes away without adding lag to motion
+#define IQS_FILTER_JITTER (1 << 0)
+// velocity/acceleration estimate, extrapolating the position by leadMicros
+// to hide the report period and bus latency
+#define IQS_FILTER_PREDICT (1 << 1)
+
+struct IQSFilterConfig
+{
+    // IQS_FILTER_* bits, 0 passes coordinates through untouched
+    uint8_t stages = 0;
+    // jitter stage: cutoff of a still finger (mHz), and how much it rises
+    // with speed (Hz per px/s, Q16)
+    uint32_t minCutoff = 1000;
+    int32_t beta = 655;
+    // cutoff (mHz) of the speed and acceleration estimates
+    uint32_t derivativeCutoff = 1000;
+    // prediction stage: how far ahead to extrapolate, at most a second
+    uint32_t leadMicros = 10000;
+};
+
+// filter state of one coordinate axis of one finger, all in Q8 fixed point
+class IQSAxisFilter
+{
+    private:
+        bool _primed = false;
+        int32_t _position = 0;     // px
+        int32_t _speed = 0;        // px/s, drives the jitter cutoff
+        int32_t _velocity = 0;     // px/s, for prediction
+        int32_t _acceleration = 0; // px/s^2, for prediction
+
+    public:
+        void reset() { _primed = false; }
+        // filter the next raw sample, taken dtMicros after the previous one.
+        // the output stays within [0, resolution - 1], the axis' resolution
+        // (0 if unknown: then only within the 16 bits the chip reports)
+        int apply(const IQSFilterConfig& config, int value, uint32_t dtMicros, int resolution = 0);
+
+        // low-pass smoothing factor (Q16) of a cutoff (mHz) at a sample period
+        static int32_t alpha(uint32_t cutoff, uint32_t dtMicros);
+};
+
+#endif // IQSFILTER_H
@@ -0,0 +1,45 @@
+#ifndef IQSFRAME_H
+#define IQSFRAME_H
+
+#include <stdint.h>
+#include "IQSRing.h"
+
+// number of decoded frames buffered per touchpad (power of two), see
+// IQSTouchpad::setFrameBuffering
+#ifndef IQS_FRAME_RING_DEPTH
+#define IQS_FRAME_RING_DEPTH 8
+#endif
+
+// one decoded communication window
+//
+// finger data is stored as arrays per field (structure of arrays) so that a
+// consumer walking one field of every finger touches contiguous memory.
+// slots past numFingers are zero
+struct IQSFrame
+{
+    // incremented for every decoded frame, including dropped ones, so gaps
+    // show up as jumps in the sequence
+    uint32_t sequence;
+    // micros() at the rising edge of RDY that opened the window
+    uint32_t timestamp;
+    // micros() when the frame had been decoded, see IQSTouchpad::acknowledgeFrame
+    uint32_t decoded;
+    // single finger gestures (0x000D) | multi finger gestures (0x000E) << 8,
+    // see the IQS_GESTURE_* bits in IQSEvents.h
+    uint16_t gestures;
+    uint8_t systemInfo0;
+    uint8_t systemInfo1;
+    // bit per slot whose finger lifted while a new one took the slot in
+    // this frame (finger tracking with all 5 slots held)
+    uint8_t replaced;
+    uint8_t numFingers;
+    uint16_t x[5];
+    uint16_t y[5];
+    uint16_t force[5];
+    uint8_t area[5];
+};
+
+// written by update(), read by the application. only one task may drain it
+typedef IQSRing<IQSFrame, IQS_FRAME_RING_DEPTH> IQSFrameRing;
+
+#endif // IQSFRAME_H
@@ -0,0 +1,285 @@
+#include "IQSGestures.h"
+
+void IQSGestures::setEdges(int x_resolution, int y_resolution, int margin)
+{
+    this->_xResolution = x_resolution;
+    this->_yResolution = y_resolution;
+    this->_edgeMargin = margin;
+}
+
+void IQSGestures::setSwipeDistance(int distance)
+{
+    this->_swipeDistance = distance;
+}
+
+void IQSGestures::setPinchThreshold(int32_t scale)
+{
+    this->_pinchThreshold = scale;
+}
+
+void IQSGestures::setRotateThreshold(int32_t angle)
+{
+    this->_rotateThreshold = angle;
+}
+
+void IQSGestures::_raise(uint8_t type, uint8_t phase, uint8_t fingers, uint8_t direction, int32_t value)
+{
+    if (this->_numEvents >= IQS_MAX_GESTURE_EVENTS)
+    {
+        return;
+    }
+    IQSGestureEvent& event = this->_events[this->_numEvents++];
+    event.type = type;
+    event.phase = phase;
+    event.fingers = fingers;
+    event.direction = direction;
+    event.value = value;
+}
+
+void IQSGestures::_endContinuous()
+{
+    if (this->_pinching)
+    {
+        this->_raise(GESTURE_PINCH, GESTURE_END, this->_fingers, DIRECTION_NONE, this->_scale);
+        this->_pinching = false;
+    }
+    if (this->_rotating)
+    {
+        this->_raise(GESTURE_ROTATE, GESTURE_END, this->_fingers, DIRECTION_NONE, this->_rotation);
+        this->_rotating = false;
+    }
+}
+
+void IQSGestures::reset()
+{
+    this->_numEvents = 0;
+    this->_endContinuous();
+    this->_fingers = 0;
+    this->_slots = 0;
+}
+
+int IQSGestures::process(const IQSFrame& frame)
+{
+    this->_numEvents = 0;
+
+    // gather the contacts and their centroid. contacts stay in their slots,
+    // which are the finger ids when IQSTouchpad tracks fingers, so each is
+    // compared with the same finger in the previous frame
+    int32_t x[5];
+    int32_t y[5];
+    int fingers = 0;
+    uint8_t slots = 0;
+    int32_t sumX = 0;
+    int32_t sumY = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        if (frame.area[i] > 0)
+        {
+            x[i] = frame.x[i];
+            y[i] = frame.y[i];
+            sumX += x[i];
+            sumY += y[i];
+            slots |= 1 << i;
+            fingers++;
+        }
+    }
+
+    int32_t centroidX = fingers > 0 ? sumX / fingers : 0;
+    int32_t centroidY = fingers > 0 ? sumY / fingers : 0;
+
+    // spread (mean squared distance from the centroid) and the rotation
+    // since the previous frame, from the summed cross and dot products of
+    // each contact's old and new offset from the centroid
+    uint64_t spread = 0;
+    int64_t cross = 0;
+    int64_t dot = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        if (!(slots & (1 << i)))
+        {
+            continue;
+        }
+        x[i] -= centroidX;
+        y[i] -= centroidY;
+        spread += (uint64_t)((int64_t)x[i] * x[i] + (int64_t)y[i] * y[i]);
+        cross += (int64_t)this->_previousX[i] * y[i] - (int64_t)this->_previousY[i] * x[i];
+        dot += (int64_t)this->_previousX[i] * x[i] + (int64_t)this->_previousY[i] * y[i];
+    }
+    if (fingers > 0)
+    {
+        spread /= fingers;
+    }
+
+    if (slots != this->_slots || frame.replaced != 0)
+    {
+        // a new contact set (a finger lifted or landed, even if another did
+        // the opposite in the same frame): end what the old one was doing
+        // and start over
+        this->_endContinuous();
+
+        if (this->_fingers == 0 && fingers == 1)
+        {
+            // a single finger landing near an edge may become an edge swipe
+            this->_edge = DIRECTION_NONE;
+            if (this->_edgeMargin > 0)
+            {
+                if (centroidX < this->_edgeMargin) { this->_edge = DIRECTION_X_POS; }
+                else if (centroidX >= this->_xResolution - this->_edgeMargin) { this->_edge = DIRECTION_X_NEG; }
+                else if (centroidY < this->_edgeMargin) { this->_edge = DIRECTION_Y_POS; }
+                else if (centroidY >= this->_yResolution - this->_edgeMargin) { this->_edge = DIRECTION_Y_NEG; }
+            }
+        }
+        else
+        {
+            // only a finger that stays alone from landing to the swipe counts
+            this->_edge = DIRECTION_NONE;
+        }
+
+        this->_fingers = fingers;
+        this->_slots = slots;
+        this->_startX = centroidX;
+        this->_startY = centroidY;
+        this->_startSpread = spread > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)spread;
+        this->_rotation = 0;
+        this->_scale = 65536;
+        this->_swiped = false;
+    }
+    else if (fingers > 0)
+    {
+        int32_t dx = centroidX - this->_startX;
+        int32_t dy = centroidY - this->_startY;
+        int32_t adx = dx < 0 ? -dx : dx;
+        int32_t ady = dy < 0 ? -dy : dy;
+
+        // the centroid travelled far enough along one dominant axis
+        uint8_t direction = DIRECTION_NONE;
+        if (adx >= this->_swipeDistance && adx >= 2 * ady)
+        {
+            direction = dx > 0 ? DIRECTION_X_POS : DIRECTION_X_NEG;
+        }
+        else if (ady >= this->_swipeDistance && ady >= 2 * adx)
+        {
+            direction = dy > 0 ? DIRECTION_Y_POS : DIRECTION_Y_NEG;
+        }
+
+        if (fingers >= 3 && direction != DIRECTION_NONE && !this->_swiped)
+        {
+            this->_swiped = true;
+            this->_raise(GESTURE_SWIPE, GESTURE_END, fingers, direction, 0);
+        }
+        else if (fingers == 1 && this->_edge != DIRECTION_NONE && direction == this->_edge && !this->_swiped)
+        {
+            this->_swiped = true;
+            this->_raise(GESTURE_EDGE_SWIPE, GESTURE_END, 1, direction, 0);
+        }
+
+        if (fingers >= 2 && !this->_swiped)
+        {
+            // scale = sqrt(spread / start spread), in Q16
+            if (this->_startSpread > 0)
+            {
+                this->_scale = (int32_t)IQSGestures::sqrt(((uint64_t)spread << 32) / this->_startSpread);
+            }
+
+            // reduce the sums to 31 bits so atan2 keeps its precision
+            while (cross > 0x3FFFFFFF || cross < -0x3FFFFFFF || dot > 0x3FFFFFFF || dot < -0x3FFFFFFF)
+            {
+                cross /= 2;
+                dot /= 2;
+            }
+            this->_rotation += IQSGestures::atan2((int32_t)cross, (int32_t)dot);
+
+            int32_t scaleChange = this->_scale - 65536;
+            if (!this->_pinching && (scaleChange >= this->_pinchThreshold || -scaleChange >= this->_pinchThreshold))
+            {
+                this->_pinching = true;
+                this->_raise(GESTURE_PINCH, GESTURE_BEGIN, fingers, DIRECTION_NONE, this->_scale);
+            }
+            else if (this->_pinching)
+            {
+                this->_raise(GESTURE_PINCH, GESTURE_UPDATE, fingers, DIRECTION_NONE, this->_scale);
+            }
+
+            if (!this->_rotating && (this->_rotation >= this->_rotateThreshold || -this->_rotation >= this->_rotateThreshold))
+            {
+                this->_rotating = true;
+                this->_raise(GESTURE_ROTATE, GESTURE_BEGIN, fingers, DIRECTION_NONE, this->_rotation);
+            }
+            else if (this->_rotating)
+            {
+                this->_raise(GESTURE_ROTATE, GESTURE_UPDATE, fingers, DIRECTION_NONE, this->_rotation);
+            }
+        }
+    }
+
+    for (int i = 0; i < 5; i++)
+    {
+        if (slots & (1 << i))
+        {
+            this->_previousX[i] = x[i];
+            this->_previousY[i] = y[i];
+        }
+    }
+
+    return this->_numEvents;
+}
+
+int32_t IQSGestures::atan2(int32_t y, int32_t x)
+{
+    // octant reduction, then atan(z) for z = min/max in [0, 1] with the
+    // odd polynomial from Abramowitz & Stegun 4.4.49 (error < 1e-5 rad), in
+    // Q30. the first coefficient is close to 1, so the small per-frame
+    // rotations that get summed up carry no systematic bias
+    if (x == 0 && y == 0)
+    {
+        return 0;
+    }
+
+    uint32_t ax = x < 0 ? -(int64_t)x : x;
+    uint32_t ay = y < 0 ? -(int64_t)y : y;
+    bool swapped = ay > ax;
+    uint32_t small = swapped ? ax : ay;
+    uint32_t large = swapped ? ay : ax;
+
+    int64_t z = (int64_t)(((uint64_t)small << 30) / large);
+    int64_t z2 = (z * z) >> 30;
+    int64_t p = 22371518;                 //  0.0208351
+    p = ((p * z2) >> 30) - 91410863;      // -0.0851330
+    p = ((p * z2) >> 30) + 193424926;     //  0.1801410
+    p = ((p * z2) >> 30) - 354656388;     // -0.3302995
+    p = ((p * z2) >> 30) + 1073597943;    //  0.9998660
+    int64_t radians = (p * z) >> 30;
+
+    // radians (Q30) to 1/65536 turn: * 65536 / (2 * pi)
+    int32_t angle = (int32_t)((radians * 10430378 / 1000 + ((int64_t)1 << 29)) >> 30);
+
+    if (swapped) { angle = 16384 - angle; }
+    if (x < 0) { angle = 32768 - angle; }
+    if (y < 0) { angle = -angle; }
+    return angle;
+}
+
+uint32_t IQSGestures::sqrt(uint64_t value)
+{
+    // bit by bit integer square root, floor(sqrt(value))
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
@@ -0,0 +1,117 @@
+#ifndef IQSGESTURES_H
+#define IQSGESTURES_H
+
+#include <stdint.h>
+#include "IQSFrame.h"
+
+// maximum number of gesture events raised by one frame
+#define IQS_MAX_GESTURE_EVENTS 8
+
+enum IQSGestureType
+{
+    GESTURE_SWIPE,      // three or more fingers moved together
+    GESTURE_PINCH,      // continuous, value is the scale since the start (Q16)
+    GESTURE_ROTATE,     // continuous, value is the angle since the start (1/65536 turn, counter-clockwise positive)
+    GESTURE_EDGE_SWIPE, // one finger came in from an edge
+};
+
+// phase of a continuous gesture, discrete gestures are always GESTURE_END
+enum IQSGesturePhase
+{
+    GESTURE_BEGIN,
+    GESTURE_UPDATE,
+    GESTURE_END,
+};
+
+// direction of a swipe (for edge swipes, away from the edge it started at)
+enum IQSDirection
+{
+    DIRECTION_NONE,
+    DIRECTION_X_POS,
+    DIRECTION_X_NEG,
+    DIRECTION_Y_POS,
+    DIRECTION_Y_NEG,
+};
+
+struct IQSGestureEvent
+{
+    uint8_t type;      // IQSGestureType
+    uint8_t phase;     // IQSGesturePhase
+    uint8_t fingers;   // number of contacts making the gesture
+    uint8_t direction; // IQSDirection, for swipes
+    int32_t value;     // scale or angle, for pinch and rotate
+};
+
+// incremental recognizer for the gestures the chip does not report
+//
+// feed it every decoded frame (from the frame ring, or
+// IQSTouchpad::lastFrame) in order. each frame costs O(fingers) integer
+// arithmetic: the centroid, the mean squared distance from it (spread) and
+// the rotation of the contacts about it are updated against the previous
+// frame and the start of the current contact set, which restarts whenever
+// a slot is taken or freed. nothing is allocated
+//
+// each contact is compared with the one in the same slot of the previous
+// frame. the chip does not keep its slot order when a finger lifts, so
+// enable IQSTouchpad::setFingerTracking(), whose slots follow the fingers
+class IQSGestures
+{
+    private:
+        // thresholds, in touchpad coordinates unless noted
+        int _swipeDistance = 300;
+        int _edgeMargin = 0;
+        int _xResolution = 0;
+        int _yResolution = 0;
+        int32_t _pinchThreshold = 65536 / 8;   // Q16, 1/8 scale change
+        int32_t _rotateThreshold = 65536 / 24; // 15 degrees
+
+        // the current contact set, and the slots it occupies
+        int _fingers = 0;
+        uint8_t _slots = 0;
+        int32_t _startX = 0;
+        int32_t _startY = 0;
+        uint32_t _startSpread = 0;
+        int32_t _rotation = 0;
+        bool _swiped = false;
+        bool _pinching = false;
+        bool _rotating = false;
+        int32_t _scale = 65536;
+        // edge the single finger started at, as the direction it must move
+        uint8_t _edge = DIRECTION_NONE;
+
+        // contacts of the previous frame, relative to their centroid
+        int32_t _previousX[5] = {};
+        int32_t _previousY[5] = {};
+
+        IQSGestureEvent _events[IQS_MAX_GESTURE_EVENTS];
+        int _numEvents = 0;
+
+        void _raise(uint8_t type, uint8_t phase, uint8_t fingers, uint8_t direction, int32_t value);
+        void _endContinuous();
+
+    public:
+        // gestures starting within margin of an edge of the given
+        // resolution are edge swipes. a margin of 0 disables them
+        void setEdges(int x_resolution, int y_resolution, int margin);
+        // distance the centroid must travel for a swipe or edge swipe
+        void setSwipeDistance(int distance);
+        // scale change (Q16) and angle (1/65536 turn) that start a pinch or rotate
+        void setPinchThreshold(int32_t scale);
+        void setRotateThreshold(int32_t angle);
+
+        // process the next frame, returns the number of events it raised
+        int process(const IQSFrame& frame);
+        // events raised by the last process(), valid until the next call
+        const IQSGestureEvent* events() { return _events; }
+        const int& numEvents = _numEvents;
+
+        // forget the current contacts, ending any gesture in progress
+        void reset();
+
+        // fixed-point helpers
+        // angle of (x, y) in 1/65536 of a turn, counter-clockwise from +x
+        static int32_t atan2(int32_t y, int32_t x);
+        static uint32_t sqrt(uint64_t value);
+};
+
+#endif // IQSGESTURES_H
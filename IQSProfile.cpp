@@ -0,0 +1,93 @@
+#include "IQSProfile.h"
+
+bool IQSProfile::valid(const byte* image, int length)
+{
+    int offset = 0;
+    while (offset < length)
+    {
+        if (length - offset < 3)
+        {
+            return false;
+        }
+        int address = (image[offset] << 8) | image[offset + 1];
+        int count = image[offset + 2];
+        if (count == 0 || address + count > 0x10000 || length - offset - 3 < count)
+        {
+            return false;
+        }
+        offset += 3 + count;
+    }
+    return true;
+}
+
+int IQSProfile::gather(const byte* image, int length, IQSProfileCursor& cursor, int& address, byte* out, int maxLength)
+{
+    int taken = 0;
+    while (taken < maxLength && cursor.record < length)
+    {
+        const byte* record = image + cursor.record;
+        int recordAddress = ((record[0] << 8) | record[1]) + cursor.done;
+        int count = record[2];
+
+        if (taken == 0)
+        {
+            address = recordAddress;
+        }
+        else if (recordAddress != address + taken)
+        {
+            // not contiguous, the next block starts here
+            break;
+        }
+
+        int chunk = count - cursor.done;
+        if (chunk > maxLength - taken)
+        {
+            chunk = maxLength - taken;
+        }
+        for (int i = 0; i < chunk; i++)
+        {
+            out[taken + i] = record[3 + cursor.done + i];
+        }
+        taken += chunk;
+        cursor.done += chunk;
+
+        if (cursor.done == count)
+        {
+            cursor.record += 3 + count;
+            cursor.done = 0;
+        }
+    }
+    return taken;
+}
+
+byte IQSProfile::verifyMask(int address)
+{
+    // the status and frame data below System Control 0 are read-only
+    if (address < 0x0431)
+    {
+        return 0;
+    }
+    switch (address)
+    {
+        // System Control 0: ACK_RESET, AUTO_ATI, ALP_RESEED and RESEED are
+        // commands that clear once the chip has acted on them, MODE_SELECT stays
+        case 0x0431:
+            return 0x07;
+        // System Control 1: RESET clears itself, SUSPEND stays
+        case 0x0432:
+            return (byte)~0x02;
+        default:
+            return 0xFF;
+    }
+}
+
+int IQSProfile::windowBytes(uint32_t frequency)
+{
+    if (IQS_PROFILE_WINDOW_BYTES >= 0)
+    {
+        return IQS_PROFILE_WINDOW_BYTES;
+    }
+    // 9 clocks per byte, plus the address phases of a few bursts
+    int bytes = (int)((uint64_t)IQS_PROFILE_WINDOW_MICROS * frequency / 9 / 1000000) - 16;
+    return bytes < 16 ? 16 : bytes;
+}
@@ -0,0 +1,68 @@
+#ifndef IQSPROFILE_H
+#define IQSPROFILE_H
+
+#include "IQSCallback.h"
+#include <Arduino.h>
+
+// configuration profile, see IQSTouchpad::loadProfile
+//
+// a profile is a byte image of records, each a register address (2 bytes,
+// big endian), a length (1 byte) and that many bytes of register data:
+//
+//     const byte profile[] = {
+//         IQS_PROFILE_RECORD(0x057A, 4), 0x00, 0x0A, 0x00, 0x32,
+//         IQS_PROFILE_RECORD(0x066E, 4), 0x0C, 0x00, 0x08, 0x00,
+//     };
+//
+// records that continue where the previous one ended are written as one
+// block, so a settings block exported from the vendor GUI can be pasted in
+// as a single record
+#define IQS_PROFILE_RECORD(address, length) (byte)((address) >> 8), (byte)((address) & 0xFF), (byte)(length)
+
+// most profile bytes (written and read back) moved in one communication
+// window, so a large profile does not hold a window open past the chip's
+// I2C timeout (0x058A). -1 sizes it from the bus clock, so that the profile
+// traffic of a window takes at most IQS_PROFILE_WINDOW_MICROS; 0 loads the
+// whole profile in one window
+#ifndef IQS_PROFILE_WINDOW_BYTES
+#define IQS_PROFILE_WINDOW_BYTES -1
+#endif
+
+// half the chip's default I2C timeout of 10 ms
+#ifndef IQS_PROFILE_WINDOW_MICROS
+#define IQS_PROFILE_WINDOW_MICROS 5000
+#endif
+
+// called once the profile is loaded, with 0 if every byte read back as
+// written (see IQSProfile::verifyMask), 12 if one did not, or the error code
+// of the failed transaction
+typedef IQSCallback<void(byte)> IQSProfileCallback;
+
+// position in a profile image
+struct IQSProfileCursor
+{
+    // start of the current record
+    int record;
+    // bytes of the current record already taken
+    int done;
+};
+
+class IQSProfile
+{
+    public:
+        // whether image holds only whole, non-empty records inside the
+        // 16 bit address space
+        static bool valid(const byte* image, int length);
+        // copy up to maxLength contiguous register bytes from the cursor to
+        // out, crossing into following records that continue at the next
+        // address. returns the number of bytes (0 at the end of the image)
+        // and their first register address
+        static int gather(const byte* image, int length, IQSProfileCursor& cursor, int& address, byte* out, int maxLength);
+        // bits of the register byte at address that keep the value written
+        // to them, and so are compared when the profile is read back
+        static byte verifyMask(int address);
+        // profile bytes per window at a bus clock, see IQS_PROFILE_WINDOW_BYTES
+        static int windowBytes(uint32_t frequency);
+};
+
+#endif // IQSPROFILE_H
@@ -1,25 +1,51 @@
 #ifndef IQSQUEUE_H
 #define IQSQUEUE_H
 
-#include <functional>
+#include "IQSCallback.h"
 #include "IQSRegisters.h"
+#include "IQSRing.h"
 #include <Arduino.h>
 
+// maximum number of pending reads/writes per touchpad. requests queued while
+// the queue is full are refused: queueRead/queueWrite return false and the
+// callback is called straight away with error code 10 (queue full)
+#ifndef IQS_READ_QUEUE_DEPTH
+#define IQS_READ_QUEUE_DEPTH 16
+#endif
+#ifndef IQS_WRITE_QUEUE_DEPTH
+#define IQS_WRITE_QUEUE_DEPTH 16
+#endif
+
+// error code of a queued modify (see IQSTouchpad::queueModify) whose register
+// could not be read into the shadow registers, so there was nothing to
+// modify. the transport's own error code is given instead if it had one
+#define IQS_ERROR_NOT_SHADOWED 13
+
+// completion callbacks, stored inline (see IQSCallback.h)
+typedef IQSCallback<void(int, int, int, byte)> IQSReadCallback;
+typedef IQSCallback<void(int, int, byte)> IQSWriteCallback;
+
 struct IQSRead
 {
     int i2cAddress;
-    IQSRegister* reg;
+    IQSRegisterInfo reg;
     // callback function which is given the i2c address, register address, read value as an int formatted according to the IQSRegister [see IQSRegister.h], and return(error) code, and should return void
-    std::function<void(int, int, int, byte)> callback;
+    IQSReadCallback callback;
 };
 
 struct IQSWrite
 {
     int i2cAddress;
-    IQSRegister* reg;
+    IQSRegisterInfo reg;
     int valueToWrite;
     // callback function which is given the i2c address, register address, and the return(error) code, and should return void
-    std::function<void(int, int, byte)> callback;
+    IQSWriteCallback callback;
+    // if not 0, only these bits of valueToWrite are written and the rest
+    // keep the value the chip holds, see IQSTouchpad::queueModify
+    int modifyMask;
 };
 
+typedef IQSRing<IQSRead, IQS_READ_QUEUE_DEPTH> IQSReadQueue;
+typedef IQSRing<IQSWrite, IQS_WRITE_QUEUE_DEPTH> IQSWriteQueue;
+
 #endif // IQSQUEUE_H
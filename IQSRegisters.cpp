@@ -1,55 +1,36 @@
 #include "IQSRegisters.h"
 #include "I2CHelpers.h"
 #include <stdexcept>
+#include <string.h>
 #include <Arduino.h>
 
-IQSRegister::IQSRegister()
-{
-    //ctor
-}
-
-IQSRegister::IQSRegister(int address, int numBytes, char mode, int dataType)
-{
-    this->_address = address;
-    this->_numBytes = numBytes;
-    this->_mode = mode;
-    this->_name = "Unknown";
-    this->_description = "Unknown";
-    this->_dataType = dataType;
-}
+constexpr IQSRegister IQSRegisterMap::registers[];
+#if IQS_REGISTER_NAMES
+constexpr const IQSRegister* IQSRegisterNameIndex::registers[];
+#endif
 
-IQSRegister::IQSRegister(int address, int numBytes, std::string name, std::string description, char mode, int dataType)
-{
-    this->_address = address;
-    this->_numBytes = numBytes;
-    this->_name = name;
-    this->_description = description;
-    this->_mode = mode;
-    this->_dataType = dataType;
-}
-
-void IQSRegister::getAddressAsByteArray(byte *byteArray)
+void IQSRegister::getAddressAsByteArray(byte *byteArray) const
 {
     I2CHelpers::intToTwoByteArray(this->_address, byteArray);
 }
 
-byte IQSRegister::read(int device_address, byte* buf)
+byte IQSRegister::read(int device_address, byte* buf) const
 {
     return I2CHelpers::readFromRegister(device_address, this->_address, this->_numBytes, buf);
 }
 
-byte IQSRegister::read(int device_address, byte* buf, int numBytesToRead)
+byte IQSRegister::read(int device_address, byte* buf, int numBytesToRead) const
 {
     return I2CHelpers::readFromRegister(device_address, this->_address, numBytesToRead, buf);
 }
 
-int IQSRegister::read(int device_address)
+int IQSRegister::read(int device_address) const
 {
     byte error;
     return this->read(device_address, error);
 }
 
-int IQSRegister::read(int device_address, byte &error)
+int IQSRegister::read(int device_address, byte &error) const
 {
     if (this->_mode == 'w')
     {
@@ -61,19 +42,34 @@ int IQSRegister::read(int device_address, byte &error)
     }
     byte buf[this->_numBytes];
     error = this->read(device_address, buf);
-    if (this->_dataType == 0 || this->_numBytes == 1)
+    if (error != 0)
+    {
+        return 0;
+    }
+    return this->decode(buf, error);
+}
+
+int IQSRegister::decode(byte* buf, byte &error) const
+{
+    return IQSRegister::decode(this->getInfo(), buf, error);
+}
+
+int IQSRegister::decode(const IQSRegisterInfo& info, byte* buf, byte &error)
+{
+    // interpret the raw bytes of a register according to its data type
+    if (info.dataType == 0 || info.numBytes == 1)
     {
         int value = buf[0];
         return value;
     }
-    else if (this->_dataType == 1)
+    else if (info.dataType == 1)
     {
-        int value = I2CHelpers::byteArrayToInt(buf, this->_numBytes);
+        int value = I2CHelpers::byteArrayToInt(buf, info.numBytes);
         return value;
     }
-    else if (this->_dataType == 2)
+    else if (info.dataType == 2)
     {
-        int value = I2CHelpers::byteArrayToSignedInt(buf, this->_numBytes);
+        int value = I2CHelpers::byteArrayToSignedInt(buf, info.numBytes);
         return value;
     }
     else
@@ -85,7 +81,7 @@ int IQSRegister::read(int device_address, byte &error)
     }
 }
 
-byte IQSRegister::write(int device_address, byte* buf)
+byte IQSRegister::write(int device_address, byte* buf) const
 {
     if (this->_mode == 'r')
     {
@@ -97,7 +93,7 @@ byte IQSRegister::write(int device_address, byte* buf)
     return I2CHelpers::writeToRegister(device_address, this->_address, this->_numBytes, buf);
 }
 
-byte IQSRegister::write(int device_address, int value)
+byte IQSRegister::write(int device_address, int value) const
 {
     if (this->_mode == 'r')
     {
@@ -128,68 +124,116 @@ byte IQSRegister::write(int device_address, int value)
     }
 }
 
-IQSRegister* IQSRegisters::getRegister(int address)
+const IQSRegister* IQSRegisters::getRegister(int address)
 {
-    return IMPORTANT_IQS_REGISTERS[address];
+    // binary search, the map is sorted by address
+    int low = 0;
+    int high = IQSRegisterMap::size - 1;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        int middleAddress = IQSRegisterMap::registers[middle].getAddress();
+        if (middleAddress == address)
+        {
+            return &IQSRegisterMap::registers[middle];
+        }
+        if (middleAddress < address)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    return nullptr;
 }
 
-IQSRegister* IQSRegisters::getRegister(std::string name)
+const IQSRegister* IQSRegisters::getRegister(const char* name)
 {
-    for (auto pair : IMPORTANT_IQS_REGISTERS)
+    #if IQS_REGISTER_NAMES
+    if (name == nullptr)
     {
-        if (pair.second->getName() == name)
+        return nullptr;
+    }
+
+    // binary search over the name index
+    int low = 0;
+    int high = IQSRegisterNameIndex::size - 1;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        int comparison = strcmp(IQSRegisterNameIndex::registers[middle]->getName(), name);
+        if (comparison == 0)
+        {
+            return IQSRegisterNameIndex::registers[middle];
+        }
+        if (comparison < 0)
+        {
+            low = middle + 1;
+        }
+        else
         {
-            return pair.second;
+            high = middle - 1;
         }
     }
-    return new IQSRegister(-1, -1, "Unknown", "Unknown");
+    #else
+    // no names to look up
+    (void)name;
+    #endif
+    return nullptr;
 }
 
-IQSRegister* IQSRegisters::NumFingers           = IMPORTANT_IQS_REGISTERS[0x0011];
-IQSRegister* IQSRegisters::Finger1RelativeX     = IMPORTANT_IQS_REGISTERS[0x0012];
-IQSRegister* IQSRegisters::Finger1RelativeY     = IMPORTANT_IQS_REGISTERS[0x0014];
-IQSRegister* IQSRegisters::Finger1AbsoluteX     = IMPORTANT_IQS_REGISTERS[0x0016];
-IQSRegister* IQSRegisters::Finger1AbsoluteY     = IMPORTANT_IQS_REGISTERS[0x0018];
-IQSRegister* IQSRegisters::Finger1TouchStrength = IMPORTANT_IQS_REGISTERS[0x001A];
-IQSRegister* IQSRegisters::Finger1TouchArea     = IMPORTANT_IQS_REGISTERS[0x001C];
-
-IQSRegister* IQSRegisters::Finger2AbsoluteX     = IMPORTANT_IQS_REGISTERS[0x001D];
-IQSRegister* IQSRegisters::Finger2AbsoluteY     = IMPORTANT_IQS_REGISTERS[0x001F];
-IQSRegister* IQSRegisters::Finger2TouchStrength = IMPORTANT_IQS_REGISTERS[0x0021];
-IQSRegister* IQSRegisters::Finger2TouchArea     = IMPORTANT_IQS_REGISTERS[0x0023];
-
-IQSRegister* IQSRegisters::Finger3AbsoluteX     = IMPORTANT_IQS_REGISTERS[0x0024];
-IQSRegister* IQSRegisters::Finger3AbsoluteY     = IMPORTANT_IQS_REGISTERS[0x0026];
-IQSRegister* IQSRegisters::Finger3TouchStrength = IMPORTANT_IQS_REGISTERS[0x0028];
-IQSRegister* IQSRegisters::Finger3TouchArea     = IMPORTANT_IQS_REGISTERS[0x002A];
-
-IQSRegister* IQSRegisters::Finger4AbsoluteX     = IMPORTANT_IQS_REGISTERS[0x002B];
-IQSRegister* IQSRegisters::Finger4AbsoluteY     = IMPORTANT_IQS_REGISTERS[0x002D];
-IQSRegister* IQSRegisters::Finger4TouchStrength = IMPORTANT_IQS_REGISTERS[0x002F];
-IQSRegister* IQSRegisters::Finger4TouchArea     = IMPORTANT_IQS_REGISTERS[0x0031];
-
-IQSRegister* IQSRegisters::Finger5AbsoluteX     = IMPORTANT_IQS_REGISTERS[0x0032];
-IQSRegister* IQSRegisters::Finger5AbsoluteY     = IMPORTANT_IQS_REGISTERS[0x0034];
-IQSRegister* IQSRegisters::Finger5TouchStrength = IMPORTANT_IQS_REGISTERS[0x0036];
-IQSRegister* IQSRegisters::Finger5TouchArea     = IMPORTANT_IQS_REGISTERS[0x0038];
+// touch data
+constexpr const IQSRegister* IQSRegisters::NumFingers;
+constexpr const IQSRegister* IQSRegisters::Finger1RelativeX;
+constexpr const IQSRegister* IQSRegisters::Finger1RelativeY;
+constexpr const IQSRegister* IQSRegisters::Finger1AbsoluteX;
+constexpr const IQSRegister* IQSRegisters::Finger1AbsoluteY;
+constexpr const IQSRegister* IQSRegisters::Finger1TouchStrength;
+constexpr const IQSRegister* IQSRegisters::Finger1TouchArea;
+
+constexpr const IQSRegister* IQSRegisters::Finger2AbsoluteX;
+constexpr const IQSRegister* IQSRegisters::Finger2AbsoluteY;
+constexpr const IQSRegister* IQSRegisters::Finger2TouchStrength;
+constexpr const IQSRegister* IQSRegisters::Finger2TouchArea;
+
+constexpr const IQSRegister* IQSRegisters::Finger3AbsoluteX;
+constexpr const IQSRegister* IQSRegisters::Finger3AbsoluteY;
+constexpr const IQSRegister* IQSRegisters::Finger3TouchStrength;
+constexpr const IQSRegister* IQSRegisters::Finger3TouchArea;
+
+constexpr const IQSRegister* IQSRegisters::Finger4AbsoluteX;
+constexpr const IQSRegister* IQSRegisters::Finger4AbsoluteY;
+constexpr const IQSRegister* IQSRegisters::Finger4TouchStrength;
+constexpr const IQSRegister* IQSRegisters::Finger4TouchArea;
+
+constexpr const IQSRegister* IQSRegisters::Finger5AbsoluteX;
+constexpr const IQSRegister* IQSRegisters::Finger5AbsoluteY;
+constexpr const IQSRegister* IQSRegisters::Finger5TouchStrength;
+constexpr const IQSRegister* IQSRegisters::Finger5TouchArea;
 
 // settings
-IQSRegister* IQSRegisters::XResolution             = IMPORTANT_IQS_REGISTERS[0x066E];
-IQSRegister* IQSRegisters::YResolution             = IMPORTANT_IQS_REGISTERS[0x0670];
-IQSRegister* IQSRegisters::ActiveModeReportRate    = IMPORTANT_IQS_REGISTERS[0x057A];
-IQSRegister* IQSRegisters::IdleTouchModeReportRate = IMPORTANT_IQS_REGISTERS[0x057C];
-IQSRegister* IQSRegisters::IdleModeReportRate      = IMPORTANT_IQS_REGISTERS[0x057E];
-IQSRegister* IQSRegisters::LP1ModeReportRate       = IMPORTANT_IQS_REGISTERS[0x0580];
-IQSRegister* IQSRegisters::LP2ModeReportRate       = IMPORTANT_IQS_REGISTERS[0x0582];
-IQSRegister* IQSRegisters::I2CTimeout              = IMPORTANT_IQS_REGISTERS[0x058A];
-IQSRegister* IQSRegisters::XYConfig0               = IMPORTANT_IQS_REGISTERS[0x0669];
-IQSRegister* IQSRegisters::MaxMultiTouches         = IMPORTANT_IQS_REGISTERS[0x066A];
-IQSRegister* IQSRegisters::DefaultReadAddress      = IMPORTANT_IQS_REGISTERS[0x0675];
+constexpr const IQSRegister* IQSRegisters::XResolution;
+constexpr const IQSRegister* IQSRegisters::YResolution;
+constexpr const IQSRegister* IQSRegisters::ActiveModeReportRate;
+constexpr const IQSRegister* IQSRegisters::IdleTouchModeReportRate;
+constexpr const IQSRegister* IQSRegisters::IdleModeReportRate;
+constexpr const IQSRegister* IQSRegisters::LP1ModeReportRate;
+constexpr const IQSRegister* IQSRegisters::LP2ModeReportRate;
+constexpr const IQSRegister* IQSRegisters::I2CTimeout;
+constexpr const IQSRegister* IQSRegisters::XYConfig0;
+constexpr const IQSRegister* IQSRegisters::MaxMultiTouches;
+constexpr const IQSRegister* IQSRegisters::DefaultReadAddress;
 
 // flags
-IQSRegister* IQSRegisters::SingleFingerGestures = IMPORTANT_IQS_REGISTERS[0x000D];
-IQSRegister* IQSRegisters::MultiFingerGestures  = IMPORTANT_IQS_REGISTERS[0x000E];
-IQSRegister* IQSRegisters::SystemInfo1          = IMPORTANT_IQS_REGISTERS[0x0010];
+constexpr const IQSRegister* IQSRegisters::SingleFingerGestures;
+constexpr const IQSRegister* IQSRegisters::MultiFingerGestures;
+constexpr const IQSRegister* IQSRegisters::SystemInfo0;
+constexpr const IQSRegister* IQSRegisters::SystemInfo1;
+
+// system control
+constexpr const IQSRegister* IQSRegisters::SystemControl0;
 
 // system status
-IQSRegister* IQSRegisters::PreviousCycleTime = IMPORTANT_IQS_REGISTERS[0x000C];
+constexpr const IQSRegister* IQSRegisters::PreviousCycleTime;
@@ -2,16 +2,31 @@
 #define IQS_REGISTERS_H
 
 #include <string>
-#include <unordered_map>
 #include <Arduino.h>
 
+// compact, trivially copyable description of a register, used where a full
+// IQSRegister is too heavy (e.g. stored inline in the request queues)
+struct IQSRegisterInfo
+{
+    int address;
+    byte numBytes;
+    char mode; // 'r' = read, 'w' = write, 'b' = read/write
+    byte dataType; // see IQSRegister::_dataType
+};
+
+// register names and descriptions are only needed for debugging and lookup
+// by name. set IQS_REGISTER_NAMES to 0 to leave the strings out of flash
+#ifndef IQS_REGISTER_NAMES
+#define IQS_REGISTER_NAMES 1
+#endif
+
+// description of one register of the IQS5xx. every member is known at
+// compile time, so the register map below lives entirely in flash
 class IQSRegister
 {
     private:
         int _address;
         int _numBytes;
-        std::string _name;
-        std::string _description;
         char _mode; // 'r' = read, 'w' = write, 'b' = read/write
 
         // dataType
@@ -20,149 +35,307 @@ class IQSRegister
         // 2 = signed int (16 bit value, one sign bit, 15 data bits)
         int _dataType;
 
+        #if IQS_REGISTER_NAMES
+        const char* _name;
+        const char* _description;
+        #endif
+
     public:
-        IQSRegister(int address, int numBytes, std::string name, std::string description, char mode = 'r', int dataType = 1);
-        IQSRegister(int address, int numBytes, char mode = 'r', int dataType = 1);
-        IQSRegister();
-        int getAddress() { return _address; }
-        int getNumBytes() { return _numBytes; }
-        std::string getName() { return _name; }
-        std::string getDescription() { return _description; }
-        char getMode() { return _mode; }
-        int getDataType() { return _dataType; }
-        void getAddressAsByteArray(byte *byteArray);
-
-        byte read(int device_address, byte* buf);
-        byte read(int device_address, byte* buf, int numBytesToRead);
-        int read(int device_address);
-        int read(int device_address, byte &error);
-
-        byte write(int device_address, byte* data);
-        byte write(int device_address, int value);
+        #if IQS_REGISTER_NAMES
+        constexpr IQSRegister(int address, int numBytes, const char* name, const char* description, char mode = 'r', int dataType = 1)
+            : _address(address), _numBytes(numBytes), _mode(mode), _dataType(dataType), _name(name), _description(description)
+        {}
+        #else
+        // the name and description are dropped
+        constexpr IQSRegister(int address, int numBytes, const char*, const char*, char mode = 'r', int dataType = 1)
+            : _address(address), _numBytes(numBytes), _mode(mode), _dataType(dataType)
+        {}
+        #endif
+        constexpr IQSRegister(int address, int numBytes, char mode = 'r', int dataType = 1)
+            : IQSRegister(address, numBytes, "Unknown", "Unknown", mode, dataType)
+        {}
+        constexpr IQSRegister()
+            : IQSRegister(-1, -1, "Unknown", "Unknown")
+        {}
+
+        constexpr int getAddress() const { return _address; }
+        constexpr int getNumBytes() const { return _numBytes; }
+        #if IQS_REGISTER_NAMES
+        constexpr const char* getName() const { return _name; }
+        constexpr const char* getDescription() const { return _description; }
+        #else
+        constexpr const char* getName() const { return ""; }
+        constexpr const char* getDescription() const { return ""; }
+        #endif
+        constexpr char getMode() const { return _mode; }
+        constexpr int getDataType() const { return _dataType; }
+        constexpr IQSRegisterInfo getInfo() const { return IQSRegisterInfo { _address, (byte)_numBytes, _mode, (byte)_dataType }; }
+        void getAddressAsByteArray(byte *byteArray) const;
+
+        byte read(int device_address, byte* buf) const;
+        byte read(int device_address, byte* buf, int numBytesToRead) const;
+        int read(int device_address) const;
+        int read(int device_address, byte &error) const;
+        int decode(byte* buf, byte &error) const;
+        static int decode(const IQSRegisterInfo& info, byte* buf, byte &error);
+
+        byte write(int device_address, byte* data) const;
+        byte write(int device_address, int value) const;
 };
 
-static std::unordered_map<int, IQSRegister*> IMPORTANT_IQS_REGISTERS
-({
-    // board info
-    {0x0000, new IQSRegister(0x0000, 2, "Product Number", "Product Number")},
-    {0x0002, new IQSRegister(0x0002, 2, "Project Number", "Project Number")},
-    {0x0004, new IQSRegister(0x0004, 1, "Major Version", "Major Version")},
-    {0x0005, new IQSRegister(0x0005, 1, "Minor Version", "Minor Version")},
-    {0x0006, new IQSRegister(0x0006, 1, "Bootloader Status", "Bootloader Status", 'r', 0)},
-
-    // misc system status info
-    {0x000B, new IQSRegister(0x000B, 1, "Max Touch", "First four bits: max touch column. Last four bits: max touch row.", 'r', 0)},
-    {0x000C, new IQSRegister(0x000C, 1, "Previous Cycle Time", "Previous Cycle Time (ms)")},
-    {0x0010, new IQSRegister(0x0010, 1, "System Info 1", "bit 7: unused, bit 6: unused, bit 5: SWITCH_STATE, bit 4: SNAP_TOGGLE, bit 3: RR_MISSED, bit 2: TOO_MANY_FINGERS, bit 1: PALM_DETECT, bit 0: TP_MOVEMENT", 'r', 0)},
-
-    // finger touch data
-    {0x0011, new IQSRegister(0x0011, 1, "Number of Finger Touches", "Number of Finger Touches")},
-
-    // finger 1 (only finger 1 has relative x/y data)
-    {0x0012, new IQSRegister(0x0012, 2, "Finger 1 Relative X", "Finger 1 Relative X (pixels)", 'r', 2)},
-    {0x0014, new IQSRegister(0x0014, 2, "Finger 1 Relative Y", "Finger 1 Relative Y (pixels)", 'r', 2)},
-    {0x0016, new IQSRegister(0x0016, 2, "Finger 1 Absolute X", "Finger 1 Absolute X (pixels)")},
-    {0x0018, new IQSRegister(0x0018, 2, "Finger 1 Absolute Y", "Finger 1 Absolute Y (pixels)")},
-    {0x001A, new IQSRegister(0x001A, 2, "Finger 1 Touch Strength", "Finger 1 Touch Strength")},
-    {0x001C, new IQSRegister(0x001C, 1, "Finger 1 Touch Area", "Finger 1 Touch Area")},
-    // finger 2
-    {0x001D, new IQSRegister(0x001D, 2, "Finger 2 Absolute X", "Finger 2 Absolute X (pixels)")},
-    {0x001F, new IQSRegister(0x001F, 2, "Finger 2 Absolute Y", "Finger 2 Absolute Y (pixels)")},
-    {0x0021, new IQSRegister(0x0021, 2, "Finger 2 Touch Strength", "Finger 2 Touch Strength")},
-    {0x0023, new IQSRegister(0x0023, 1, "Finger 2 Touch Area", "Finger 2 Touch Area")},
-    // finger 3
-    {0x0024, new IQSRegister(0x0024, 2, "Finger 3 Absolute X", "Finger 3 Absolute X (pixels)")},
-    {0x0026, new IQSRegister(0x0026, 2, "Finger 3 Absolute Y", "Finger 3 Absolute Y (pixels)")},
-    {0x0028, new IQSRegister(0x0028, 2, "Finger 3 Touch Strength", "Finger 3 Touch Strength")},
-    {0x002A, new IQSRegister(0x002A, 1, "Finger 3 Touch Area", "Finger 3 Touch Area")},
-    // finger 4
-    {0x002B, new IQSRegister(0x002B, 2, "Finger 4 Absolute X", "Finger 4 Absolute X (pixels)")},
-    {0x002D, new IQSRegister(0x002D, 2, "Finger 4 Absolute Y", "Finger 4 Absolute Y (pixels)")},
-    {0x002F, new IQSRegister(0x002F, 2, "Finger 4 Touch Strength", "Finger 4 Touch Strength")},
-    {0x0031, new IQSRegister(0x0031, 1, "Finger 4 Touch Area", "Finger 4 Touch Area")},
-    // finger 5
-    {0x0032, new IQSRegister(0x0032, 2, "Finger 5 Absolute X", "Finger 5 Absolute X (pixels)")},
-    {0x0034, new IQSRegister(0x0034, 2, "Finger 5 Absolute Y", "Finger 5 Absolute Y (pixels)")},
-    {0x0036, new IQSRegister(0x0036, 2, "Finger 5 Touch Strength", "Finger 5 Touch Strength")},
-    {0x0038, new IQSRegister(0x0038, 1, "Finger 5 Touch Area", "Finger 5 Touch Area")},
-
-    // settings
-    {0x066E, new IQSRegister(0x066E, 2, "X Resolution", "X Resolution", 'b')},
-    {0x0670, new IQSRegister(0x0670, 2, "Y Resolution", "Y Resolution", 'b')},
-    {0x057A, new IQSRegister(0x057A, 2, "Active Mode Report Rate", "Active Mode Report Rate (ms)", 'b')},
-    {0x057C, new IQSRegister(0x057C, 2, "Idle Touch Mode Report Rate", "Idle Touch Mode Report Rate (ms)", 'b')},
-    {0x057E, new IQSRegister(0x057E, 2, "Idle Mode Report Rate", "Idle Mode Report Rate (ms)", 'b')},
-    {0x0580, new IQSRegister(0x0580, 2, "LP1 Mode Report Rate", "Low Power 1 Mode Report Rate (ms)", 'b')},
-    {0x0582, new IQSRegister(0x0582, 2, "LP2 Mode Report Rate", "Low Power 2 Mode Report Rate (ms)", 'b')},
-    {0x058A, new IQSRegister(0x058A, 1, "I2C Timeout", "I2C Timeout (ms)", 'b')},
-    {0x0669, new IQSRegister(0x0669, 1, "XY Config 0", "bits 7-4: unused, bit 3: PALM_REJECT, bit 2: SWITCH_XY_AXIS, bit 1: FLIP_Y, bit 0: FLIP_X", 'b', 0)},
-    {0x066A, new IQSRegister(0x066A, 1, "Max multi-touches", "Maximum number of concurrent fingers", 'b', 1)},
-    {0x0675, new IQSRegister(0x0675, 2, "Default read address", "Default read address", 'b')},
-
-    // gesture data
-    {0x000D, new IQSRegister(0x000D, 1, "Single Finger Gestures", "bit 7: unused, bit 6: unused, bit 5: SWIPE Y-, bit 4: SWIPE Y+, bit 3: SWIPE X+, bit 2: SWIPE X-, bit 1: PRESS AND HOLD, bit 0: SINGLE TAP", 'r', 0)},
-    {0x000E, new IQSRegister(0x000E, 1, "Multi Finger Gestures", "bit 7: unused, bit 6: unused, bit 5: unused, bit 4: unused, bit 3: unused, bit 2: ZOOM, bit 1: SCROLL, bit 0: TWO FINGER TAP", 'r', 0)},
-
-    // gesture settings
-    {0x06B7, new IQSRegister(0x06B7, 1, "Single Finger Gestures Settings", "bit 7: unused, bit 6: unused, bit 5: SWIPE Y-, bit 4: SWIPE Y+, bit 3: SWIPE X+, bit 2: SWIPE X-, bit 1: PRESS AND HOLD, bit 0: SINGLE TAP | 0 disables, 1 enables", 'b', 0)},
-    {0x06B8, new IQSRegister(0x06B8, 1, "Multi Finger Gestures Settings", "bit 7: unused, bit 6: unused, bit 5: unused, bit 4: unused, bit 3: unused, bit 2: ZOOM, bit 1: SCROLL, bit 0: TWO FINGER TAP | 0 disables, 1 enables", 'b', 0)},
-});
+// the registers of the IQS5xx that this library knows about, sorted by address
+struct IQSRegisterMap
+{
+    static constexpr IQSRegister registers[] =
+    {
+        // board info
+        IQSRegister(0x0000, 2, "Product Number", "Product Number"),
+        IQSRegister(0x0002, 2, "Project Number", "Project Number"),
+        IQSRegister(0x0004, 1, "Major Version", "Major Version"),
+        IQSRegister(0x0005, 1, "Minor Version", "Minor Version"),
+        IQSRegister(0x0006, 1, "Bootloader Status", "Bootloader Status", 'r', 0),
+
+        // misc system status info
+        IQSRegister(0x000B, 1, "Max Touch", "First four bits: max touch column. Last four bits: max touch row.", 'r', 0),
+        IQSRegister(0x000C, 1, "Previous Cycle Time", "Previous Cycle Time (ms)"),
+
+        // gesture data
+        IQSRegister(0x000D, 1, "Single Finger Gestures", "bit 7: unused, bit 6: unused, bit 5: SWIPE Y-, bit 4: SWIPE Y+, bit 3: SWIPE X+, bit 2: SWIPE X-, bit 1: PRESS AND HOLD, bit 0: SINGLE TAP", 'r', 0),
+        IQSRegister(0x000E, 1, "Multi Finger Gestures", "bit 7: unused, bit 6: unused, bit 5: unused, bit 4: unused, bit 3: unused, bit 2: ZOOM, bit 1: SCROLL, bit 0: TWO FINGER TAP", 'r', 0),
+
+        // system info
+        IQSRegister(0x000F, 1, "System Info 0", "bit 7: SHOW_RESET, bit 6: ALP_REATI_OCCURRED, bit 5: ALP_ATI_ERROR, bit 4: REATI_OCCURRED, bit 3: ATI_ERROR, bits 2-0: CHARGING_MODE", 'r', 0),
+        IQSRegister(0x0010, 1, "System Info 1", "bit 7: unused, bit 6: unused, bit 5: SWITCH_STATE, bit 4: SNAP_TOGGLE, bit 3: RR_MISSED, bit 2: TOO_MANY_FINGERS, bit 1: PALM_DETECT, bit 0: TP_MOVEMENT", 'r', 0),
+
+        // finger touch data
+        IQSRegister(0x0011, 1, "Number of Finger Touches", "Number of Finger Touches"),
+
+        // finger 1 (only finger 1 has relative x/y data)
+        IQSRegister(0x0012, 2, "Finger 1 Relative X", "Finger 1 Relative X (pixels)", 'r', 2),
+        IQSRegister(0x0014, 2, "Finger 1 Relative Y", "Finger 1 Relative Y (pixels)", 'r', 2),
+        IQSRegister(0x0016, 2, "Finger 1 Absolute X", "Finger 1 Absolute X (pixels)"),
+        IQSRegister(0x0018, 2, "Finger 1 Absolute Y", "Finger 1 Absolute Y (pixels)"),
+        IQSRegister(0x001A, 2, "Finger 1 Touch Strength", "Finger 1 Touch Strength"),
+        IQSRegister(0x001C, 1, "Finger 1 Touch Area", "Finger 1 Touch Area"),
+
+        // finger 2
+        IQSRegister(0x001D, 2, "Finger 2 Absolute X", "Finger 2 Absolute X (pixels)"),
+        IQSRegister(0x001F, 2, "Finger 2 Absolute Y", "Finger 2 Absolute Y (pixels)"),
+        IQSRegister(0x0021, 2, "Finger 2 Touch Strength", "Finger 2 Touch Strength"),
+        IQSRegister(0x0023, 1, "Finger 2 Touch Area", "Finger 2 Touch Area"),
+
+        // finger 3
+        IQSRegister(0x0024, 2, "Finger 3 Absolute X", "Finger 3 Absolute X (pixels)"),
+        IQSRegister(0x0026, 2, "Finger 3 Absolute Y", "Finger 3 Absolute Y (pixels)"),
+        IQSRegister(0x0028, 2, "Finger 3 Touch Strength", "Finger 3 Touch Strength"),
+        IQSRegister(0x002A, 1, "Finger 3 Touch Area", "Finger 3 Touch Area"),
+
+        // finger 4
+        IQSRegister(0x002B, 2, "Finger 4 Absolute X", "Finger 4 Absolute X (pixels)"),
+        IQSRegister(0x002D, 2, "Finger 4 Absolute Y", "Finger 4 Absolute Y (pixels)"),
+        IQSRegister(0x002F, 2, "Finger 4 Touch Strength", "Finger 4 Touch Strength"),
+        IQSRegister(0x0031, 1, "Finger 4 Touch Area", "Finger 4 Touch Area"),
+
+        // finger 5
+        IQSRegister(0x0032, 2, "Finger 5 Absolute X", "Finger 5 Absolute X (pixels)"),
+        IQSRegister(0x0034, 2, "Finger 5 Absolute Y", "Finger 5 Absolute Y (pixels)"),
+        IQSRegister(0x0036, 2, "Finger 5 Touch Strength", "Finger 5 Touch Strength"),
+        IQSRegister(0x0038, 1, "Finger 5 Touch Area", "Finger 5 Touch Area"),
+
+        // system control
+        IQSRegister(0x0431, 1, "System Control 0", "bit 7: ACK_RESET, bit 6: unused, bit 5: AUTO_ATI, bit 4: ALP_RESEED, bit 3: RESEED, bits 2-0: MODE_SELECT", 'b', 0),
+
+        // settings
+        IQSRegister(0x057A, 2, "Active Mode Report Rate", "Active Mode Report Rate (ms)", 'b'),
+        IQSRegister(0x057C, 2, "Idle Touch Mode Report Rate", "Idle Touch Mode Report Rate (ms)", 'b'),
+        IQSRegister(0x057E, 2, "Idle Mode Report Rate", "Idle Mode Report Rate (ms)", 'b'),
+        IQSRegister(0x0580, 2, "LP1 Mode Report Rate", "Low Power 1 Mode Report Rate (ms)", 'b'),
+        IQSRegister(0x0582, 2, "LP2 Mode Report Rate", "Low Power 2 Mode Report Rate (ms)", 'b'),
+        IQSRegister(0x058A, 1, "I2C Timeout", "I2C Timeout (ms)", 'b'),
+        IQSRegister(0x0669, 1, "XY Config 0", "bits 7-4: unused, bit 3: PALM_REJECT, bit 2: SWITCH_XY_AXIS, bit 1: FLIP_Y, bit 0: FLIP_X", 'b', 0),
+        IQSRegister(0x066A, 1, "Max multi-touches", "Maximum number of concurrent fingers", 'b', 1),
+        IQSRegister(0x066E, 2, "X Resolution", "X Resolution", 'b'),
+        IQSRegister(0x0670, 2, "Y Resolution", "Y Resolution", 'b'),
+        IQSRegister(0x0675, 2, "Default read address", "Default read address", 'b'),
+
+        // gesture settings
+        IQSRegister(0x06B7, 1, "Single Finger Gestures Settings", "bit 7: unused, bit 6: unused, bit 5: SWIPE Y-, bit 4: SWIPE Y+, bit 3: SWIPE X+, bit 2: SWIPE X-, bit 1: PRESS AND HOLD, bit 0: SINGLE TAP | 0 disables, 1 enables", 'b', 0),
+        IQSRegister(0x06B8, 1, "Multi Finger Gestures Settings", "bit 7: unused, bit 6: unused, bit 5: unused, bit 4: unused, bit 3: unused, bit 2: ZOOM, bit 1: SCROLL, bit 0: TWO FINGER TAP | 0 disables, 1 enables", 'b', 0),
+    };
+
+    static constexpr int size = sizeof(registers) / sizeof(registers[0]);
+};
+
+// index of a register in IQSRegisterMap::registers, or -1 if it is not there
+constexpr int iqsRegisterIndex(int address, int index = 0)
+{
+    return index >= IQSRegisterMap::size ? -1
+        : IQSRegisterMap::registers[index].getAddress() == address ? index
+        : iqsRegisterIndex(address, index + 1);
+}
+
+// compile-time handle to a register in IQSRegisterMap
+template <int ADDRESS>
+constexpr const IQSRegister* iqsRegister()
+{
+    static_assert(iqsRegisterIndex(ADDRESS) >= 0, "register is not in IQSRegisterMap");
+    return &IQSRegisterMap::registers[iqsRegisterIndex(ADDRESS)];
+}
+
+// true if IQSRegisterMap::registers is strictly sorted by address, which the
+// binary search in IQSRegisters::getRegister(int) relies on
+constexpr bool iqsRegistersSortedByAddress(int index = 1)
+{
+    return index >= IQSRegisterMap::size ? true
+        : IQSRegisterMap::registers[index - 1].getAddress() < IQSRegisterMap::registers[index].getAddress()
+          && iqsRegistersSortedByAddress(index + 1);
+}
+static_assert(iqsRegistersSortedByAddress(), "IQSRegisterMap::registers must be sorted by address");
+
+#if IQS_REGISTER_NAMES
+// strcmp, usable at compile time
+constexpr int iqsCompareNames(const char* a, const char* b)
+{
+    return (*a != *b || *a == '\0') ? (int)(unsigned char)*a - (int)(unsigned char)*b
+        : iqsCompareNames(a + 1, b + 1);
+}
+
+// the registers of IQSRegisterMap again, sorted by name (byte-wise, case
+// sensitive) for IQSRegisters::getRegister(const char*)
+struct IQSRegisterNameIndex
+{
+    static constexpr const IQSRegister* registers[] =
+    {
+        iqsRegister<0x057A>(),
+        iqsRegister<0x0006>(),
+        iqsRegister<0x0675>(),
+        iqsRegister<0x0016>(),
+        iqsRegister<0x0018>(),
+        iqsRegister<0x0012>(),
+        iqsRegister<0x0014>(),
+        iqsRegister<0x001C>(),
+        iqsRegister<0x001A>(),
+        iqsRegister<0x001D>(),
+        iqsRegister<0x001F>(),
+        iqsRegister<0x0023>(),
+        iqsRegister<0x0021>(),
+        iqsRegister<0x0024>(),
+        iqsRegister<0x0026>(),
+        iqsRegister<0x002A>(),
+        iqsRegister<0x0028>(),
+        iqsRegister<0x002B>(),
+        iqsRegister<0x002D>(),
+        iqsRegister<0x0031>(),
+        iqsRegister<0x002F>(),
+        iqsRegister<0x0032>(),
+        iqsRegister<0x0034>(),
+        iqsRegister<0x0038>(),
+        iqsRegister<0x0036>(),
+        iqsRegister<0x058A>(),
+        iqsRegister<0x057E>(),
+        iqsRegister<0x057C>(),
+        iqsRegister<0x0580>(),
+        iqsRegister<0x0582>(),
+        iqsRegister<0x0004>(),
+        iqsRegister<0x000B>(),
+        iqsRegister<0x066A>(),
+        iqsRegister<0x0005>(),
+        iqsRegister<0x000E>(),
+        iqsRegister<0x06B8>(),
+        iqsRegister<0x0011>(),
+        iqsRegister<0x000C>(),
+        iqsRegister<0x0000>(),
+        iqsRegister<0x0002>(),
+        iqsRegister<0x000D>(),
+        iqsRegister<0x06B7>(),
+        iqsRegister<0x0431>(),
+        iqsRegister<0x000F>(),
+        iqsRegister<0x0010>(),
+        iqsRegister<0x066E>(),
+        iqsRegister<0x0669>(),
+        iqsRegister<0x0670>(),
+    };
+
+    static constexpr int size = sizeof(registers) / sizeof(registers[0]);
+};
+
+constexpr bool iqsRegistersSortedByName(int index = 1)
+{
+    return index >= IQSRegisterNameIndex::size ? true
+        : iqsCompareNames(IQSRegisterNameIndex::registers[index - 1]->getName(), IQSRegisterNameIndex::registers[index]->getName()) < 0
+          && iqsRegistersSortedByName(index + 1);
+}
+static_assert(IQSRegisterNameIndex::size == IQSRegisterMap::size, "IQSRegisterNameIndex must list every register in IQSRegisterMap");
+static_assert(iqsRegistersSortedByName(), "IQSRegisterNameIndex must be sorted by name, and names must be unique");
+#endif
 
 class IQSRegisters
 {
-    private:
-        // use enum trick to initialize array in class definition
     public:
-        static IQSRegister* getRegister(int address);
-        static IQSRegister* getRegister(std::string name);
+        // lookup by address or by exact name, in O(log n) without allocating.
+        // both return nullptr if the register is not in IQSRegisterMap (name
+        // lookup always does when IQS_REGISTER_NAMES is 0)
+        static const IQSRegister* getRegister(int address);
+        static const IQSRegister* getRegister(const char* name);
+        static const IQSRegister* getRegister(const std::string& name) { return getRegister(name.c_str()); }
+
+        // compile-time handle to a register in the map, e.g.
+        // IQSRegisters::get<0x0011>(). an address that is not in the map does
+        // not compile
+        template <int ADDRESS>
+        static constexpr const IQSRegister* get() { return iqsRegister<ADDRESS>(); }
 
         // often used registers
 
         // touch data
-        static IQSRegister* NumFingers;
-        static IQSRegister* Finger1RelativeX;
-        static IQSRegister* Finger1RelativeY;
-        static IQSRegister* Finger1AbsoluteX;
-        static IQSRegister* Finger1AbsoluteY;
-        static IQSRegister* Finger1TouchStrength;
-        static IQSRegister* Finger1TouchArea;
-        static IQSRegister* Finger2AbsoluteX;
-        static IQSRegister* Finger2AbsoluteY;
-        static IQSRegister* Finger2TouchStrength;
-        static IQSRegister* Finger2TouchArea;
-        static IQSRegister* Finger3AbsoluteX;
-        static IQSRegister* Finger3AbsoluteY;
-        static IQSRegister* Finger3TouchStrength;
-        static IQSRegister* Finger3TouchArea;
-        static IQSRegister* Finger4AbsoluteX;
-        static IQSRegister* Finger4AbsoluteY;
-        static IQSRegister* Finger4TouchStrength;
-        static IQSRegister* Finger4TouchArea;
-        static IQSRegister* Finger5AbsoluteX;
-        static IQSRegister* Finger5AbsoluteY;
-        static IQSRegister* Finger5TouchStrength;
-        static IQSRegister* Finger5TouchArea;
+        static constexpr const IQSRegister* NumFingers           = iqsRegister<0x0011>();
+        static constexpr const IQSRegister* Finger1RelativeX     = iqsRegister<0x0012>();
+        static constexpr const IQSRegister* Finger1RelativeY     = iqsRegister<0x0014>();
+        static constexpr const IQSRegister* Finger1AbsoluteX     = iqsRegister<0x0016>();
+        static constexpr const IQSRegister* Finger1AbsoluteY     = iqsRegister<0x0018>();
+        static constexpr const IQSRegister* Finger1TouchStrength = iqsRegister<0x001A>();
+        static constexpr const IQSRegister* Finger1TouchArea     = iqsRegister<0x001C>();
+        static constexpr const IQSRegister* Finger2AbsoluteX     = iqsRegister<0x001D>();
+        static constexpr const IQSRegister* Finger2AbsoluteY     = iqsRegister<0x001F>();
+        static constexpr const IQSRegister* Finger2TouchStrength = iqsRegister<0x0021>();
+        static constexpr const IQSRegister* Finger2TouchArea     = iqsRegister<0x0023>();
+        static constexpr const IQSRegister* Finger3AbsoluteX     = iqsRegister<0x0024>();
+        static constexpr const IQSRegister* Finger3AbsoluteY     = iqsRegister<0x0026>();
+        static constexpr const IQSRegister* Finger3TouchStrength = iqsRegister<0x0028>();
+        static constexpr const IQSRegister* Finger3TouchArea     = iqsRegister<0x002A>();
+        static constexpr const IQSRegister* Finger4AbsoluteX     = iqsRegister<0x002B>();
+        static constexpr const IQSRegister* Finger4AbsoluteY     = iqsRegister<0x002D>();
+        static constexpr const IQSRegister* Finger4TouchStrength = iqsRegister<0x002F>();
+        static constexpr const IQSRegister* Finger4TouchArea     = iqsRegister<0x0031>();
+        static constexpr const IQSRegister* Finger5AbsoluteX     = iqsRegister<0x0032>();
+        static constexpr const IQSRegister* Finger5AbsoluteY     = iqsRegister<0x0034>();
+        static constexpr const IQSRegister* Finger5TouchStrength = iqsRegister<0x0036>();
+        static constexpr const IQSRegister* Finger5TouchArea     = iqsRegister<0x0038>();
 
         // settings
-        static IQSRegister* XResolution;
-        static IQSRegister* YResolution;
-        static IQSRegister* ActiveModeReportRate;
-        static IQSRegister* IdleTouchModeReportRate;
-        static IQSRegister* IdleModeReportRate;
-        static IQSRegister* LP1ModeReportRate;
-        static IQSRegister* LP2ModeReportRate;
-        static IQSRegister* I2CTimeout;
-        static IQSRegister* XYConfig0;
-        static IQSRegister* MaxMultiTouches;
-        static IQSRegister* DefaultReadAddress;
+        static constexpr const IQSRegister* XResolution             = iqsRegister<0x066E>();
+        static constexpr const IQSRegister* YResolution             = iqsRegister<0x0670>();
+        static constexpr const IQSRegister* ActiveModeReportRate    = iqsRegister<0x057A>();
+        static constexpr const IQSRegister* IdleTouchModeReportRate = iqsRegister<0x057C>();
+        static constexpr const IQSRegister* IdleModeReportRate      = iqsRegister<0x057E>();
+        static constexpr const IQSRegister* LP1ModeReportRate       = iqsRegister<0x0580>();
+        static constexpr const IQSRegister* LP2ModeReportRate       = iqsRegister<0x0582>();
+        static constexpr const IQSRegister* I2CTimeout              = iqsRegister<0x058A>();
+        static constexpr const IQSRegister* XYConfig0               = iqsRegister<0x0669>();
+        static constexpr const IQSRegister* MaxMultiTouches         = iqsRegister<0x066A>();
+        static constexpr const IQSRegister* DefaultReadAddress      = iqsRegister<0x0675>();
 
         // flags
-        static IQSRegister* SingleFingerGestures;
-        static IQSRegister* MultiFingerGestures;
-        static IQSRegister* SystemInfo1;
+        static constexpr const IQSRegister* SingleFingerGestures = iqsRegister<0x000D>();
+        static constexpr const IQSRegister* MultiFingerGestures  = iqsRegister<0x000E>();
+        static constexpr const IQSRegister* SystemInfo0          = iqsRegister<0x000F>();
+        static constexpr const IQSRegister* SystemInfo1          = iqsRegister<0x0010>();
+
+        // system control
+        static constexpr const IQSRegister* SystemControl0 = iqsRegister<0x0431>();
 
         // system status
-        static IQSRegister* PreviousCycleTime;
+        static constexpr const IQSRegister* PreviousCycleTime = iqsRegister<0x000C>();
 
 };
 
@@ -0,0 +1,123 @@
+#ifndef IQSRING_H
+#define IQSRING_H
+
+#include <atomic>
+#include <utility>
+
+// fixed-capacity, lock-free FIFO ring buffer, storage is inline so it never
+// allocates
+//
+// any number of producers (tasks, threads, ISRs) may push() concurrently;
+// only one consumer may pop(). each cell carries a sequence number that tells
+// producers whether it is free and the consumer whether it has been
+// published, so producers only contend on one compare-and-swap of the tail
+// and never wait for each other or for the consumer
+//
+// push() refuses new items when the ring is full (the caller decides what to
+// do with the overflow), and pop() moves items out so that owning members
+// (e.g. callbacks) are transferred rather than copied
+template <typename T, int N>
+class IQSRing
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "IQSRing capacity must be a power of two");
+
+    private:
+        struct Cell
+        {
+            std::atomic<unsigned> sequence;
+            T item;
+        };
+
+        Cell _cells[N];
+        std::atomic<unsigned> _tail;
+        // only touched by the consumer
+        unsigned _head = 0;
+
+    public:
+        IQSRing()
+        {
+            for (int i = 0; i < N; i++)
+            {
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            _tail.store(0, std::memory_order_relaxed);
+        }
+
+        static int capacity() { return N; }
+
+        // only exact when no push is in progress
+        int size()
+        {
+            return (int)(_tail.load(std::memory_order_acquire) - _head);
+        }
+        bool empty() { return size() == 0; }
+        bool full() { return size() >= N; }
+
+        bool push(const T& item)
+        {
+            unsigned position = _tail.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true)
+            {
+                cell = &_cells[position & (N - 1)];
+                unsigned sequence = cell->sequence.load(std::memory_order_acquire);
+                int difference = (int)(sequence - position);
+                if (difference == 0)
+                {
+                    // the cell is free, try to claim it
+                    if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    // the cell still holds an item from the previous lap: full
+                    return false;
+                }
+                else
+                {
+                    // another producer claimed this cell first
+                    position = _tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->item = item;
+            // publish to the consumer
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // copies the next item without removing it, consumer only
+        bool peek(T& item)
+        {
+            Cell* cell = &_cells[_head & (N - 1)];
+            unsigned sequence = cell->sequence.load(std::memory_order_acquire);
+            if ((int)(sequence - (_head + 1)) < 0)
+            {
+                return false;
+            }
+
+            item = cell->item;
+            return true;
+        }
+
+        bool pop(T& item)
+        {
+            Cell* cell = &_cells[_head & (N - 1)];
+            unsigned sequence = cell->sequence.load(std::memory_order_acquire);
+            if ((int)(sequence - (_head + 1)) < 0)
+            {
+                // empty, or the next item is claimed but not yet published
+                return false;
+            }
+
+            item = std::move(cell->item);
+            // hand the cell back to the producers for the next lap
+            cell->sequence.store(_head + N, std::memory_order_release);
+            _head++;
+            return true;
+        }
+};
+
+#endif // IQSRING_H
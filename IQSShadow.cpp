@@ -0,0 +1,130 @@
+#include "IQSShadow.h"
+
+void IQSShadowRegisters::_setBits(uint8_t* bits, int offset, int length, bool value)
+{
+    for (int i = offset; i < offset + length; i++)
+    {
+        if (value)
+        {
+            bits[i >> 3] |= 1 << (i & 7);
+        }
+        else
+        {
+            bits[i >> 3] &= ~(1 << (i & 7));
+        }
+    }
+}
+
+bool IQSShadowRegisters::covers(int address, int numBytes)
+{
+    return IQS_SHADOW_LENGTH > 0 && numBytes > 0 &&
+           address >= IQS_SHADOW_FIRST && address + numBytes - 1 <= IQS_SHADOW_LAST;
+}
+
+bool IQSShadowRegisters::known(int address, int numBytes) const
+{
+    if (!IQSShadowRegisters::covers(address, numBytes))
+    {
+        return false;
+    }
+    for (int i = 0; i < numBytes; i++)
+    {
+        if (!IQSShadowRegisters::_bit(this->_known, address - IQS_SHADOW_FIRST + i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IQSShadowRegisters::get(int address, int numBytes, int& value) const
+{
+    if (!this->known(address, numBytes))
+    {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < numBytes; i++)
+    {
+        value = (value << 8) | this->_values[address - IQS_SHADOW_FIRST + i];
+    }
+    return true;
+}
+
+void IQSShadowRegisters::set(int address, const byte* bytes, int numBytes)
+{
+    for (int i = 0; i < numBytes; i++)
+    {
+        if (IQSShadowRegisters::covers(address + i, 1))
+        {
+            int offset = address + i - IQS_SHADOW_FIRST;
+            this->_values[offset] = bytes[i];
+            IQSShadowRegisters::_setBits(this->_known, offset, 1, true);
+        }
+    }
+}
+
+void IQSShadowRegisters::forget(int address, int numBytes)
+{
+    for (int i = 0; i < numBytes; i++)
+    {
+        if (IQSShadowRegisters::covers(address + i, 1))
+        {
+            IQSShadowRegisters::_setBits(this->_known, address + i - IQS_SHADOW_FIRST, 1, false);
+        }
+    }
+}
+
+void IQSShadowRegisters::forgetAll()
+{
+    IQSShadowRegisters::_setBits(this->_known, 0, IQS_SHADOW_LENGTH, false);
+}
+
+void IQSShadowRegisters::want(int address, int numBytes)
+{
+    if (IQSShadowRegisters::covers(address, numBytes))
+    {
+        IQSShadowRegisters::_setBits(this->_wanted, address - IQS_SHADOW_FIRST, numBytes, true);
+    }
+}
+
+void IQSShadowRegisters::wantAll()
+{
+    IQSShadowRegisters::_setBits(this->_wanted, 0, IQS_SHADOW_LENGTH, true);
+}
+
+bool IQSShadowRegisters::nextWanted(int& address, int& length, int maxLength) const
+{
+    int first = -1;
+    int last = -1;
+    for (int i = 0; i < IQS_SHADOW_LENGTH; i++)
+    {
+        if (!IQSShadowRegisters::_bit(this->_wanted, i))
+        {
+            continue;
+        }
+        if (first == -1)
+        {
+            first = i;
+        }
+        else if (i - first >= maxLength)
+        {
+            break;
+        }
+        last = i;
+    }
+    if (first == -1)
+    {
+        return false;
+    }
+    address = IQS_SHADOW_FIRST + first;
+    length = last - first + 1;
+    return true;
+}
+
+void IQSShadowRegisters::filled(int address, int length, bool success)
+{
+    int offset = address - IQS_SHADOW_FIRST;
+    IQSShadowRegisters::_setBits(this->_wanted, offset, length, false);
+    IQSShadowRegisters::_setBits(this->_known, offset, length, success);
+}
@@ -0,0 +1,64 @@
+#ifndef IQSSHADOW_H
+#define IQSSHADOW_H
+
+#include <stdint.h>
+#include <Arduino.h>
+
+// keep a copy of the settings registers of each touchpad, so that writes of
+// the value the chip already holds are skipped and bitfield changes (see
+// IQSTouchpad::queueModify) need no read window of their own. costs about
+// 400 bytes of RAM per touchpad; set to 0 to leave it out
+#ifndef IQS_SHADOW_REGISTERS
+#define IQS_SHADOW_REGISTERS 1
+#endif
+
+// the shadowed range: report rates (0x057A) to the gesture settings (0x06B8)
+#define IQS_SHADOW_FIRST 0x057A
+#define IQS_SHADOW_LAST 0x06B8
+#if IQS_SHADOW_REGISTERS
+#define IQS_SHADOW_LENGTH (IQS_SHADOW_LAST - IQS_SHADOW_FIRST + 1)
+#else
+#define IQS_SHADOW_LENGTH 0
+#endif
+
+// byte-wise copy of the shadowed range. every byte is either known (read
+// from, or successfully written to, the chip since the last reset) or not,
+// and can be wanted (to be read in the next window)
+class IQSShadowRegisters
+{
+    private:
+        static const int _length = IQS_SHADOW_LENGTH;
+        // at least one byte each, so the arrays exist when the shadow is left out
+        byte _values[_length > 0 ? _length : 1] = {};
+        uint8_t _known[(_length + 7) / 8 > 0 ? (_length + 7) / 8 : 1] = {};
+        uint8_t _wanted[(_length + 7) / 8 > 0 ? (_length + 7) / 8 : 1] = {};
+
+        static bool _bit(const uint8_t* bits, int offset) { return (bits[offset >> 3] >> (offset & 7)) & 1; }
+        static void _setBits(uint8_t* bits, int offset, int length, bool value);
+
+    public:
+        // whether the registers [address, address + numBytes) are all in the shadow
+        static bool covers(int address, int numBytes);
+
+        bool known(int address, int numBytes) const;
+        // big endian value of known registers, false if any byte is unknown
+        bool get(int address, int numBytes, int& value) const;
+        // record bytes the chip holds, clipped to the shadowed range
+        void set(int address, const byte* bytes, int numBytes);
+        void forget(int address, int numBytes);
+        void forgetAll();
+
+        // mark registers to be read into the shadow
+        void want(int address, int numBytes);
+        void wantAll();
+        // the next read that fetches wanted bytes: from the first wanted byte,
+        // up to maxLength bytes but no further than the last wanted one.
+        // false if nothing is wanted
+        bool nextWanted(int& address, int& length, int maxLength) const;
+        // a fill read finished: the bytes are no longer wanted, and known if it succeeded
+        void filled(int address, int length, bool success);
+        // where a fill read of address lands
+        byte* data(int address) { return this->_values + (address - IQS_SHADOW_FIRST); }
+};
+
+#endif // IQSSHADOW_H
@@ -0,0 +1,90 @@
+#include "IQSStats.h"
+
+void IQSLatencyHistogram::add(uint32_t micros)
+{
+    int index = 0;
+    while (index < IQS_LATENCY_BUCKETS - 1 && micros > IQSLatencyHistogram::bucketLimit(index))
+    {
+        index++;
+    }
+    this->_buckets[index]++;
+    this->_count++;
+    if (micros > this->_max)
+    {
+        this->_max = micros;
+    }
+}
+
+uint32_t IQSLatencyHistogram::bucketLimit(int index)
+{
+    if (index >= IQS_LATENCY_BUCKETS - 1 || index >= 32)
+    {
+        return 0xFFFFFFFF;
+    }
+    return ((uint32_t)1 << index) - 1;
+}
+
+uint32_t IQSLatencyHistogram::percentile(int percent) const
+{
+    if (this->_count == 0)
+    {
+        return 0;
+    }
+    // the smallest bucket with at least percent% of the samples at or below it
+    uint64_t wanted = ((uint64_t)this->_count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < IQS_LATENCY_BUCKETS; i++)
+    {
+        seen += this->_buckets[i];
+        if (seen >= wanted && seen > 0)
+        {
+            // never more than the worst sample seen
+            uint32_t limit = IQSLatencyHistogram::bucketLimit(i);
+            return limit < this->_max ? limit : this->_max;
+        }
+    }
+    return this->_max;
+}
+
+void IQSLatencyHistogram::printTo(Print& out, const char* name) const
+{
+    out.print(name);
+    out.print(": n=");
+    out.print((unsigned long)this->_count);
+    out.print(" p50<=");
+    out.print((unsigned long)this->percentile(50));
+    out.print(" p90<=");
+    out.print((unsigned long)this->percentile(90));
+    out.print(" p99<=");
+    out.print((unsigned long)this->percentile(99));
+    out.print(" max=");
+    out.print((unsigned long)this->_max);
+    out.println(" us");
+
+    for (int i = 0; i < IQS_LATENCY_BUCKETS; i++)
+    {
+        if (this->_buckets[i] == 0)
+        {
+            continue;
+        }
+        out.print("  <=");
+        if (i == IQS_LATENCY_BUCKETS - 1)
+        {
+            out.print("inf");
+        }
+        else
+        {
+            out.print((unsigned long)IQSLatencyHistogram::bucketLimit(i));
+        }
+        out.print(" us: ");
+        out.println((unsigned long)this->_buckets[i]);
+    }
+}
+
+void IQSLatencyStats::printTo(Print& out) const
+{
+    this->readyToOpen.printTo(out, "RDY -> window open");
+    this->openToDecoded.printTo(out, "window open -> decoded");
+    this->decodedToAck.printTo(out, "decoded -> ack");
+    this->readyToAck.printTo(out, "RDY -> ack");
+}
@@ -0,0 +1,119 @@
+#ifndef IQSSTATS_H
+#define IQSSTATS_H
+
+#include <stdint.h>
+#include <Arduino.h>
+
+// per-touchpad counters of the communication windows, see
+// IQSTouchpad::windowStats. on by default in the host build only; when 0 the
+// counters are compiled out and windowStats() stays empty
+#ifndef IQS_INSTRUMENTATION
+#if defined(IQS_HOST)
+#define IQS_INSTRUMENTATION 1
+#else
+#define IQS_INSTRUMENTATION 0
+#endif
+#endif
+
+// PreviousCycleTime (0x000C) is read once every this many windows, as one
+// extra byte alongside the queued reads
+#ifndef IQS_CYCLE_TIME_SAMPLE_PERIOD
+#define IQS_CYCLE_TIME_SAMPLE_PERIOD 64
+#endif
+
+#if IQS_INSTRUMENTATION
+#define IQS_INSTRUMENT(...) __VA_ARGS__
+#else
+#define IQS_INSTRUMENT(...)
+#endif
+
+// error codes are counted individually up to this, larger ones together
+#define IQS_STATS_ERROR_CODES 16
+
+// min/max/mean of one quantity
+struct IQSStatRange
+{
+    uint32_t count = 0;
+    uint32_t min = 0xFFFFFFFF;
+    uint32_t max = 0;
+    uint64_t total = 0;
+
+    void add(uint32_t value)
+    {
+        count++;
+        if (value < min) { min = value; }
+        if (value > max) { max = value; }
+        total += value;
+    }
+    uint32_t mean() const { return count ? total / count : 0; }
+};
+
+struct IQSWindowStats
+{
+    // windows completed
+    uint32_t windows = 0;
+    // per window: bus transactions, bytes moved (both directions), RDY edge
+    // to end of window (us), time in read/write/profile/frame callbacks (us)
+    // and requests drained from the queues
+    IQSStatRange transactions;
+    IQSStatRange bytes;
+    IQSStatRange duration;
+    IQSStatRange callbackMicros;
+    IQSStatRange readsDrained;
+    IQSStatRange writesDrained;
+    // failed transactions by error code (see I2CHelpers and IQSBus.h)
+    uint32_t errors[IQS_STATS_ERROR_CODES] = {};
+    // frames with RR_MISSED set
+    uint32_t reportRateMissed = 0;
+    // the chip's own cycle time (ms), sampled every IQS_CYCLE_TIME_SAMPLE_PERIOD windows
+    IQSStatRange cycleTime;
+};
+
+// latency histograms: bucket 0 holds 0 us, bucket i (i >= 1) holds
+// 2^(i-1) to 2^i - 1 us, and the last bucket everything longer
+#ifndef IQS_LATENCY_BUCKETS
+#define IQS_LATENCY_BUCKETS 21
+#endif
+
+class IQSLatencyHistogram
+{
+    private:
+        uint32_t _buckets[IQS_LATENCY_BUCKETS] = {};
+        uint32_t _count = 0;
+        uint32_t _max = 0;
+
+    public:
+        void add(uint32_t micros);
+        void reset() { *this = IQSLatencyHistogram(); }
+
+        uint32_t count() const { return _count; }
+        uint32_t max() const { return _max; }
+        uint32_t bucket(int index) const { return _buckets[index]; }
+        // largest latency (us) that bucket index can hold
+        static uint32_t bucketLimit(int index);
+        // upper bound (us) of the latency that percent% of the samples stay
+        // within, to bucket resolution (at most a factor of two over)
+        uint32_t percentile(int percent) const;
+
+        // one line of count, p50/p90/p99 and max, then one line per
+        // non-empty bucket
+        void printTo(Print& out, const char* name) const;
+};
+
+// where a frame's time goes, from the RDY edge (timestamped in the ISR) to
+// the application acknowledging it (see IQSTouchpad::acknowledgeFrame)
+struct IQSLatencyStats
+{
+    // RDY edge to update() starting the window
+    IQSLatencyHistogram readyToOpen;
+    // window start to the frame being decoded
+    IQSLatencyHistogram openToDecoded;
+    // frame decoded to acknowledged
+    IQSLatencyHistogram decodedToAck;
+    // the whole way, RDY edge to acknowledged
+    IQSLatencyHistogram readyToAck;
+
+    void printTo(Print& out) const;
+};
+
+#endif // IQSSTATS_H
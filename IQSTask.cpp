@@ -0,0 +1,180 @@
+#include "IQSTask.h"
+
+IQSTask::~IQSTask()
+{
+    this->stop();
+}
+
+#ifdef IQS_HAS_FREERTOS
+
+void IQSTask::_main(void* task)
+{
+    IQSTask* self = static_cast<IQSTask*>(task);
+    self->_function(self->_argument);
+
+    // a FreeRTOS task must not return, it deletes itself instead
+    self->_running = false;
+    self->_handle = nullptr;
+    vTaskDelete(nullptr);
+}
+
+bool IQSTask::start(void (*function)(void*), void* argument, const char* name, int core, int priority)
+{
+    if (this->_running)
+    {
+        return false;
+    }
+    this->_function = function;
+    this->_argument = argument;
+    this->_stopRequested = false;
+    this->_running = true;
+
+    TaskHandle_t handle = nullptr;
+    #ifdef ESP32
+    BaseType_t created = xTaskCreatePinnedToCore(IQSTask::_main, name, IQS_TASK_STACK_SIZE, this, priority, &handle, core < 0 ? tskNO_AFFINITY : core);
+    #else
+    // tasks cannot be pinned here
+    (void)core;
+    BaseType_t created = xTaskCreate(IQSTask::_main, name, IQS_TASK_STACK_SIZE, this, priority, &handle);
+    #endif
+    if (created != pdPASS)
+    {
+        this->_running = false;
+        return false;
+    }
+    this->_handle = handle;
+    return true;
+}
+
+void IQSTask::stop()
+{
+    if (!this->_running)
+    {
+        return;
+    }
+    this->_stopRequested = true;
+    while (this->_running)
+    {
+        TaskHandle_t handle = this->_handle;
+        if (handle != nullptr)
+        {
+            xTaskNotifyGive(handle);
+        }
+        vTaskDelay(1);
+    }
+}
+
+void IRAM_ATTR IQSTask::notifyFromISR()
+{
+    TaskHandle_t handle = this->_handle;
+    if (handle == nullptr)
+    {
+        return;
+    }
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(handle, &woken);
+    // the ESP32 port's portYIELD_FROM_ISR takes no argument on older cores,
+    // the ARM ports (nRF52) need the flag
+    #ifdef ESP32
+    if (woken)
+    {
+        portYIELD_FROM_ISR();
+    }
+    #else
+    portYIELD_FROM_ISR(woken);
+    #endif
+}
+
+bool IQSTask::wait(uint32_t timeoutMillis)
+{
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMillis));
+    return !this->_stopRequested;
+}
+
+void IQSTask::pause()
+{
+    // taskYIELD() would only let tasks of the same or higher priority run
+    vTaskDelay(1);
+}
+
+#elif defined(IQS_HOST)
+
+bool IQSTask::start(void (*function)(void*), void* argument, const char* name, int core, int priority)
+{
+    if (this->_running)
+    {
+        return false;
+    }
+    // a std::thread takes no name, core or priority
+    (void)name;
+    (void)core;
+    (void)priority;
+    this->_function = function;
+    this->_argument = argument;
+    this->_stopRequested = false;
+    this->_notifications = 0;
+    this->_running = true;
+    this->_thread = std::thread([this]()
+    {
+        this->_function(this->_argument);
+        this->_running = false;
+    });
+    return true;
+}
+
+void IQSTask::stop()
+{
+    if (!this->_thread.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_stopRequested = true;
+    }
+    this->_condition.notify_one();
+    this->_thread.join();
+}
+
+void IQSTask::notifyFromISR()
+{
+    if (!this->_running)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_notifications++;
+    }
+    this->_condition.notify_one();
+}
+
+bool IQSTask::wait(uint32_t timeoutMillis)
+{
+    std::unique_lock<std::mutex> lock(this->_mutex);
+    this->_condition.wait_for(lock, std::chrono::milliseconds(timeoutMillis), [this]()
+    {
+        return this->_notifications > 0 || this->_stopRequested;
+    });
+    this->_notifications = 0;
+    return !this->_stopRequested;
+}
+
+void IQSTask::pause()
+{
+    std::this_thread::yield();
+}
+
+#else
+
+bool IQSTask::start(void (*)(void*), void*, const char*, int, int)
+{
+    return false;
+}
+
+void IQSTask::stop() {}
+void IQSTask::notifyFromISR() {}
+bool IQSTask::wait(uint32_t) { return false; }
+void IQSTask::pause() {}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef IQSTASK_H
+#define IQSTASK_H
+
+#include <Arduino.h>
+
+// a dedicated task that sleeps until it is notified (from an ISR) or a
+// timeout passes. FreeRTOS cores get a real task, pinned to a core where
+// the core supports it (ESP32); the host build gets a std::thread and a
+// condition variable, so the same code can be tested against the emulator
+#if defined(ESP32) || defined(ARDUINO_NRF52_ADAFRUIT)
+#define IQS_HAS_FREERTOS 1
+#endif
+
+#if defined(IQS_HAS_FREERTOS) || defined(IQS_HOST)
+#define IQS_HAS_TASKS 1
+#endif
+
+// only the ESP32 core places ISRs in IRAM
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+#ifdef IQS_HAS_FREERTOS
+    #ifdef ESP32
+    #include <freertos/FreeRTOS.h>
+    #include <freertos/task.h>
+    #else
+    #include <FreeRTOS.h>
+    #include <task.h>
+    #endif
+#elif defined(IQS_HOST)
+    #include <thread>
+    #include <mutex>
+    #include <condition_variable>
+#endif
+
+// stack of the acquisition task, in the unit the core's xTaskCreate takes
+// (bytes on ESP32, words elsewhere). unused on the host
+#ifndef IQS_TASK_STACK_SIZE
+#define IQS_TASK_STACK_SIZE 4096
+#endif
+
+class IQSTask
+{
+    private:
+        void (*_function)(void*) = nullptr;
+        void* _argument = nullptr;
+        volatile bool _stopRequested = false;
+        volatile bool _running = false;
+
+        #ifdef IQS_HAS_FREERTOS
+        TaskHandle_t volatile _handle = nullptr;
+        static void _main(void* task);
+        #elif defined(IQS_HOST)
+        std::thread _thread;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        unsigned _notifications = 0;
+        #endif
+
+    public:
+        ~IQSTask();
+
+        // run function(argument) in a new task, returns false if a task is
+        // already running or tasks are not supported on this core. core is
+        // only honoured where tasks can be pinned (ESP32), -1 for any core
+        bool start(void (*function)(void*), void* argument, const char* name, int core, int priority);
+        // ask the task to return and wait until it has. not from the task itself
+        void stop();
+        bool running() { return _running; }
+
+        // wake the task, safe to call from an ISR
+        void notifyFromISR();
+
+        // for use inside the task: sleep until notified or timeoutMillis
+        // has passed. returns false once stop() has been requested
+        bool wait(uint32_t timeoutMillis);
+        // for use inside the task, while polling the bus: give up the CPU
+        // for a tick, so that lower priority tasks (loop()) run meanwhile.
+        // the host build only yields, its clock is virtual anyway
+        void pause();
+};
+
+#endif // IQSTASK_H
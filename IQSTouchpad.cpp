@@ -2,14 +2,12 @@
 #include <Wire.h>
 #include "I2CHelpers.h"
 #include "IQSRegisters.h"
-#include <vector>
 #include "Finger.h"
-#include <queue>
-#include <functional>
 #include "IQSQueue.h"
+#include <algorithm>
 #include <Arduino.h>
 
-std::vector<IQSTouchpad*> IQSTouchpad::_touchpads = std::vector<IQSTouchpad*>();
+IQSTouchpad* volatile IQSTouchpad::_touchpads[IQS_MAX_TOUCHPADS] = {};
 
 IQSTouchpad::IQSTouchpad(int PIN_RDY, int PIN_RST, int X_resolution, int Y_resolution, bool switch_xy_axis, bool flip_y, bool flip_x, int maxFingers, byte i2cAddress)
 {
@@ -18,67 +16,30 @@ IQSTouchpad::IQSTouchpad(int PIN_RDY, int PIN_RST, int X_resolution, int Y_resol
     this->_i2cAddress = i2cAddress;
     this->_initialized = false;
 
-    // queue settings writes
-    this->setResolution(X_resolution, Y_resolution);
+    // queue settings writes. a resolution of -1 keeps the chip's own
+    if (X_resolution >= 0 && Y_resolution >= 0)
+    {
+        this->setResolution(X_resolution, Y_resolution);
+    }
     this->setXYConfig0(true, switch_xy_axis, flip_y, flip_x);
     this->setMaxFingers(maxFingers);
 
     // set default read address
-    //this->_setDefaultReadAddress(IQSRegisters::SingleFingerGestures);
-    this->queueWrite(0x0675, 2, 0x000D);
-}
-
-void IQSTouchpad::queueRead(IQSRead read)
-{
-    this->_readQueue.push(read);
-}
-
-void IQSTouchpad::queueRead(IQSRegister* reg, std::function<void(int, byte)> callback)
-{
-    // define a lambda function that will take the i2cAddress, registerAddress, read value, and return code and pass only the read value and return code to the callback function
-    auto callbackWrapper = [callback](int i2cAddress, int registerAddress, int readValue, byte returnCode)
-    {
-        callback(readValue, returnCode);
-    };
-
-    // create a read object and add it to the queue
-    IQSRead newRead = {
-        this->_i2cAddress,
-        reg,
-        callbackWrapper
-    };
-
-    this->_readQueue.push(newRead);
-}
-
-void IQSTouchpad::queueRead(int registerAddress, int numBytes, std::function<void(int, int, byte)> callback, int dataType)
-{
-    this->queueRead(registerAddress, numBytes, dataType, callback);
+    this->_setDefaultReadAddress(IQSRegisters::SingleFingerGestures);
 }
 
-
-void IQSTouchpad::queueRead(int registerAddress, int numBytes, int dataType, std::function<void(int,int,byte)> callback)
+bool IQSTouchpad::queueRead(IQSRead read)
 {
-    // define a lambda function that will take the i2cAddress, registerAddress, read value, and return code and pass only the read value and return code to the callback function
-    auto callbackWrapper = [callback](int i2cAddress, int registerAddress, int readValue, byte returnCode)
+    if (!this->_readQueue.push(read))
     {
-        callback(registerAddress, readValue, returnCode);
-    };
-
-    // create an IQSRegister object
-    IQSRegister* reg = new IQSRegister(registerAddress, numBytes, "", "", dataType);
-
-    // create a read object and add it to the queue
-    IQSRead newRead = {
-        this->_i2cAddress,
-        reg,
-        callbackWrapper
-    };
-
-    this->_readQueue.push(newRead);
+        // error code 10: queue full
+        read.callback(read.i2cAddress, read.reg.address, 0, 10);
+        return false;
+    }
+    return true;
 }
 
-void IQSTouchpad::queueWrite(IQSWrite write)
+bool IQSTouchpad::queueWrite(IQSWrite write)
 {
     // refuse to write to the default read address register
     /*
@@ -89,135 +50,158 @@ void IQSTouchpad::queueWrite(IQSWrite write)
         return;
     }*/
 
-    this->_writeQueue.push(write);
+    if (!this->_writeQueue.push(write))
+    {
+        // error code 10: queue full
+        write.callback(write.i2cAddress, write.reg.address, 10);
+        return false;
+    }
+    return true;
 }
 
-void IQSTouchpad::queueWrite(IQSRegister* reg, int value)
+bool IQSTouchpad::queueWrite(const IQSRegister* reg, int value)
 {
-
-    // create a blank callback function
-    auto callbackWrapper = [](int i2cAddress, int registerAddress, byte returnCode)
-    {
-    };
-
-    // create a write object and add it to the queue
+    // create a write object with a blank callback and add it to the queue
     IQSWrite newWrite = {
         this->_i2cAddress,
-        reg,
+        reg->getInfo(),
         value,
-        callbackWrapper
+        nullptr,
+        // write every bit
+        0
     };
 
-    this->_writeQueue.push(newWrite);
+    return this->queueWrite(newWrite);
 }
-void IQSTouchpad::queueWrite(IQSRegister* reg, int value, std::function<void(int, byte)> callback)
-{
 
-    // create a wrapper callback function
-    auto callbackWrapper = [callback](int i2cAddress, int registerAddress, byte returnCode)
-    {
-        callback(registerAddress, returnCode);
-    };
-
-    // create a write object and add it to the queue
+bool IQSTouchpad::queueWrite(int registerAddress, int numBytes, int value)
+{
+    // create a write object with a blank callback and add it to the queue
     IQSWrite newWrite = {
         this->_i2cAddress,
-        reg,
+        IQSRegisterInfo { registerAddress, (byte)numBytes, 'b', 0 },
         value,
-        callbackWrapper
+        nullptr,
+        // write every bit
+        0
     };
 
-    this->_writeQueue.push(newWrite);
+    return this->queueWrite(newWrite);
 }
 
-void IQSTouchpad::queueWrite(int registerAddress, int numBytes, int value)
+bool IQSTouchpad::queueModify(const IQSRegister* reg, int mask, int value)
 {
-    // create an IQSRegister object
-    IQSRegister* reg = new IQSRegister(registerAddress, numBytes, 'b', 0);
-
-    // create a blank callback function
-    auto callbackWrapper = [](int i2cAddress, int registerAddress, byte returnCode)
+    if (mask == 0)
     {
-    };
+        // nothing to change
+        return true;
+    }
 
-    // create a write object and add it to the queue
     IQSWrite newWrite = {
         this->_i2cAddress,
-        reg,
+        reg->getInfo(),
         value,
-        callbackWrapper
+        nullptr,
+        mask
     };
 
-    this->_writeQueue.push(newWrite);
+    return this->queueWrite(newWrite);
 }
 
-void IQSTouchpad::queueWrite(int registerAddress, int numBytes, int value, std::function<void(int,byte)> callback)
+bool IQSTouchpad::loadProfile(const byte* image, int length, IQSProfileCallback callback)
 {
-    // create an IQSRegister object
-    IQSRegister* reg = new IQSRegister(registerAddress, numBytes, 'b', 0);
-
-    // create a wrapper callback function
-    auto callbackWrapper = [callback](int i2cAddress, int registerAddress, byte returnCode)
+    if (this->_profilePending)
     {
-        callback(registerAddress, returnCode);
-    };
+        // error code 7: refused
+        callback(7);
+        return false;
+    }
+    if (image == nullptr || !IQSProfile::valid(image, length))
+    {
+        // error code 9: bad type
+        callback(9);
+        return false;
+    }
 
-    // create a write object and add it to the queue
-    IQSWrite newWrite = {
-        this->_i2cAddress,
-        reg,
-        value,
-        callbackWrapper
-    };
+    this->_profile = image;
+    this->_profileLength = length;
+    this->_profileCallback = callback;
+    this->_profileVerifying = false;
+    this->_profileCursor = IQSProfileCursor {};
+    // published last, the window picks the profile up from here
+    this->_profilePending = true;
+    return true;
+}
+
+bool IQSTouchpad::profileLoading()
+{
+    return this->_profilePending;
+}
+
+void IQSTouchpad::loadShadowRegisters()
+{
+    // picked up by the next window, which owns the shadow
+    this->_shadowLoadRequested = true;
+}
 
-    this->_writeQueue.push(newWrite);
+bool IQSTouchpad::getShadowRegister(const IQSRegister* reg, int& value)
+{
+    return this->_shadow.get(reg->getAddress(), reg->getNumBytes(), value);
 }
 
-void IQSTouchpad::_setDefaultReadAddress(IQSRegister* reg)
+void IQSTouchpad::_setDefaultReadAddress(const IQSRegister* reg)
 {
     this->queueWrite(IQSRegisters::DefaultReadAddress, reg->getAddress());
 }
 
 void IQSTouchpad::setResolution(int x_res, int y_res)
 {
-    auto callback_x = [this, x_res](int registerAddress, byte returnCode)
+    auto callback_x = [this, x_res](int, byte returnCode)
     {
         if (returnCode == 0)
         {
             this->_X_resolution = x_res;
+            this->_configApplied |= IQS_CONFIG_X_RESOLUTION;
         }
     };
-    auto callback_y = [this, y_res](int registerAddress, byte returnCode)
+    auto callback_y = [this, y_res](int, byte returnCode)
     {
         if (returnCode == 0)
         {
             this->_Y_resolution = y_res;
+            this->_configApplied |= IQS_CONFIG_Y_RESOLUTION;
         }
     };
-    //this->queueWrite(IQSRegisters::XResolution, x_res, callback_x);
-    //this->queueWrite(IQSRegisters::YResolution, y_res, callback_y);
-    this->queueWrite(0x066E, 2, x_res, callback_x);
-    this->queueWrite(0x0670, 2, y_res, callback_y);
+    this->queueWrite(IQSRegisters::XResolution, x_res, callback_x);
+    this->queueWrite(IQSRegisters::YResolution, y_res, callback_y);
 }
 
 void IQSTouchpad::setXYConfig0(byte value)
 {
-    //this->queueWrite(IQSRegisters::XYConfig0, value);
-    this->queueWrite(0x0669, 1, value);
+    auto callback = [this, value](int, byte returnCode)
+    {
+        if (returnCode == 0)
+        {
+            this->_xyConfig0 = value;
+            this->_configApplied |= IQS_CONFIG_XY_CONFIG_0;
+        }
+    };
+
+    this->queueWrite(IQSRegisters::XYConfig0, value, callback);
 }
 
 void IQSTouchpad::setMaxFingers(int max_fingers)
 {
-    auto callback = [this, max_fingers](int registerAddress, byte returnCode)
+    auto callback = [this, max_fingers](int, byte returnCode)
     {
         if (returnCode == 0)
         {
             this->_maxFingers = max_fingers;
+            this->_configApplied |= IQS_CONFIG_MAX_FINGERS;
         }
     };
 
-    //this->queueWrite(IQSRegisters::MaxMultiTouches, max_fingers, callback);
-    this->queueWrite(0x066A, 1, max_fingers, callback);
+    this->queueWrite(IQSRegisters::MaxMultiTouches, max_fingers, callback);
 }
 
 void IQSTouchpad::setXYConfig0(bool PALM_REJECT, bool SWITCH_XY_AXIS, bool FLIP_Y, bool FLIP_X)
@@ -241,27 +225,31 @@ void IQSTouchpad::setReportRate(int report_rate_milliseconds, TouchpadMode mode)
     //  LP1 Mode
     //  LP2 Mode
 
+    auto callback = [this, report_rate_milliseconds](int, byte returnCode)
+    {
+        if (returnCode == 0)
+        {
+            this->_reportRate = report_rate_milliseconds;
+            this->_configApplied |= IQS_CONFIG_REPORT_RATE;
+        }
+    };
+
     switch (mode)
     {
         case TouchpadMode::ACTIVE:
-            //this->queueWrite(IQSRegisters::ActiveModeReportRate, report_rate_milliseconds);
-            this->queueWrite(0x057A, 2, report_rate_milliseconds);
+            this->queueWrite(IQSRegisters::ActiveModeReportRate, report_rate_milliseconds, callback);
             break;
         case TouchpadMode::IDLE_TOUCH:
-            //this->queueWrite(IQSRegisters::IdleTouchModeReportRate, report_rate_milliseconds);
-            this->queueWrite(0x057C, 2, report_rate_milliseconds);
+            this->queueWrite(IQSRegisters::IdleTouchModeReportRate, report_rate_milliseconds);
             break;
         case TouchpadMode::IDLE:
-            //this->queueWrite(IQSRegisters::IdleModeReportRate, report_rate_milliseconds);
-            this->queueWrite(0x057E, 2, report_rate_milliseconds);
+            this->queueWrite(IQSRegisters::IdleModeReportRate, report_rate_milliseconds);
             break;
         case TouchpadMode::LP1:
-            //this->queueWrite(IQSRegisters::LP1ModeReportRate, report_rate_milliseconds);
-            this->queueWrite(0x0580, 2, report_rate_milliseconds);
+            this->queueWrite(IQSRegisters::LP1ModeReportRate, report_rate_milliseconds);
             break;
         case TouchpadMode::LP2:
-            //this->queueWrite(IQSRegisters::LP2ModeReportRate, report_rate_milliseconds);
-            this->queueWrite(0x0582, 2, report_rate_milliseconds);
+            this->queueWrite(IQSRegisters::LP2ModeReportRate, report_rate_milliseconds);
             break;
         default:
             break;
@@ -281,54 +269,261 @@ Finger IQSTouchpad::getFinger(int finger_index)
     return this->_fingers[finger_index];
 }
 
-namespace IQSInterrupt
+// RDY interrupt dispatch
+//
+// each touchpad owns one slot of a fixed registry and is bound to its own
+// RDY pin, so an edge costs one store regardless of how many touchpads
+// there are. the interrupt only fires on the rising edge (window opening).
+// the ESP32 core can pass the touchpad straight to the handler; other cores
+// get one trampoline per registry slot
+
+void IRAM_ATTR IQSTouchpad::_onReady(IQSTouchpad* touchpad)
+{
+    if (touchpad->_ready)
+    {
+        touchpad->_windowsMissed = touchpad->_windowsMissed + 1;
+    }
+    touchpad->_readyMicros = micros();
+    touchpad->_ready = true;
+    touchpad->_task.notifyFromISR();
+}
+
+void IRAM_ATTR IQSTouchpad::_readyISR(void* touchpad)
+{
+    IQSTouchpad::_onReady(static_cast<IQSTouchpad*>(touchpad));
+}
+
+template <int SLOT>
+void IQSTouchpad::_readyTrampoline()
+{
+    IQSTouchpad* touchpad = IQSTouchpad::_touchpads[SLOT];
+    if (touchpad != nullptr)
+    {
+        IQSTouchpad::_onReady(touchpad);
+    }
+}
+
+static_assert(IQS_MAX_TOUCHPADS >= 1 && IQS_MAX_TOUCHPADS <= 8, "IQS_MAX_TOUCHPADS must be between 1 and 8");
+
+void (*IQSTouchpad::_trampoline(int slot))()
+{
+    switch (slot)
+    {
+        // only slots that exist in _touchpads get a trampoline
+        case 0: return &IQSTouchpad::_readyTrampoline<0>;
+#if IQS_MAX_TOUCHPADS > 1
+        case 1: return &IQSTouchpad::_readyTrampoline<1>;
+#endif
+#if IQS_MAX_TOUCHPADS > 2
+        case 2: return &IQSTouchpad::_readyTrampoline<2>;
+#endif
+#if IQS_MAX_TOUCHPADS > 3
+        case 3: return &IQSTouchpad::_readyTrampoline<3>;
+#endif
+#if IQS_MAX_TOUCHPADS > 4
+        case 4: return &IQSTouchpad::_readyTrampoline<4>;
+#endif
+#if IQS_MAX_TOUCHPADS > 5
+        case 5: return &IQSTouchpad::_readyTrampoline<5>;
+#endif
+#if IQS_MAX_TOUCHPADS > 6
+        case 6: return &IQSTouchpad::_readyTrampoline<6>;
+#endif
+#if IQS_MAX_TOUCHPADS > 7
+        case 7: return &IQSTouchpad::_readyTrampoline<7>;
+#endif
+        default: return nullptr;
+    }
+}
+
+bool IQSTouchpad::_attachReadyInterrupt()
 {
+    // find this touchpad's slot, or claim a free one
+    int slot = -1;
+    for (int i = 0; i < IQS_MAX_TOUCHPADS; i++)
+    {
+        if (IQSTouchpad::_touchpads[i] == this)
+        {
+            slot = i;
+            break;
+        }
+        if (slot == -1 && IQSTouchpad::_touchpads[i] == nullptr)
+        {
+            slot = i;
+        }
+    }
+    if (slot == -1)
+    {
+        // registry full, raise IQS_MAX_TOUCHPADS
+        return false;
+    }
+
+    // the slot is filled before the interrupt can fire
+    IQSTouchpad::_touchpads[slot] = this;
+
     #ifdef ESP32
-    // ESP32 needs IRAM_ATTR
-    void IRAM_ATTR IQSInterruptHandler()
-    #endif
-    #ifdef NRF52_SERIES
-    void IQSInterruptHandler()
+    attachInterruptArg(digitalPinToInterrupt(this->_PIN_RDY), IQSTouchpad::_readyISR, this, RISING);
+    #else
+    attachInterrupt(digitalPinToInterrupt(this->_PIN_RDY), IQSTouchpad::_trampoline(slot), RISING);
     #endif
+
+    // a window that opened before the interrupt was attached has no edge left
+    if (digitalRead(this->_PIN_RDY))
+    {
+        this->_readyMicros = micros();
+        this->_ready = true;
+    }
+
+    return true;
+}
+
+IQSTouchpad::~IQSTouchpad()
+{
+    this->endAcquisitionTask();
+
+    for (int i = 0; i < IQS_MAX_TOUCHPADS; i++)
     {
-        // loop through all the touchpads and find the one that triggered the interrupt
-        for (int i = 0; i < IQSTouchpad::_touchpads.size(); i++)
+        if (IQSTouchpad::_touchpads[i] == this)
         {
-            IQSTouchpad *touchpad = IQSTouchpad::_touchpads[i];
-            if (digitalRead(touchpad->PIN_RDY))
-            {
-                if (!touchpad->_ready)
-                {
-                    touchpad->_ready = true;
-                }
-            }
+            detachInterrupt(digitalPinToInterrupt(this->_PIN_RDY));
+            IQSTouchpad::_touchpads[i] = nullptr;
         }
     }
 }
 
 void IQSTouchpad::reset()
 {
-    // Reset the touchpad
+    // the pulse is short enough to wait out, the boot is not
     digitalWrite(this->_PIN_RST, LOW);
-    delay(200);
+    delayMicroseconds(IQS_RESET_PULSE_US);
+    // RDY edges from before the reset are stale
+    this->_ready = false;
+    this->_resetMicros = micros();
+    this->_booting = true;
     digitalWrite(this->_PIN_RST, HIGH);
-    delay(200);
+
+    // the settings are back to their defaults, so the next window has to set
+    // the default read address before any frame can be read. settings queued
+    // in the constructor have not been applied yet if the chip was never up
+    if (this->_initialized)
+    {
+        this->_queueConfiguration();
+    }
+    this->_initialized = false;
+    this->_shadow.forgetAll();
+    this->_resetExpected = true;
 }
 
-void IQSTouchpad::_begin()
+bool IQSTouchpad::resetInProgress()
+{
+    return this->_booting;
+}
+
+bool IQSTouchpad::_updateReset()
+{
+    if (!this->_booting)
+    {
+        return false;
+    }
+    if (this->_ready)
+    {
+        // the first window, the chip is up
+        this->_booting = false;
+        return false;
+    }
+    if (micros() - this->_resetMicros < (uint32_t)IQS_BOOT_TIMEOUT_MS * 1000)
+    {
+        return true;
+    }
+    // no edge seen: carry on, and serve a window that is already open
+    this->_bootTimeouts++;
+    this->_booting = false;
+    if (digitalRead(this->_PIN_RDY))
+    {
+        this->_readyMicros = micros();
+        this->_ready = true;
+    }
+    return false;
+}
+
+void IQSTouchpad::_queueConfiguration()
+{
+    // the values last written successfully, settings that never were keep
+    // the chip's defaults
+    byte applied = this->_configApplied;
+    if (applied & IQS_CONFIG_X_RESOLUTION)
+    {
+        this->queueWrite(IQSRegisters::XResolution, this->_X_resolution);
+    }
+    if (applied & IQS_CONFIG_Y_RESOLUTION)
+    {
+        this->queueWrite(IQSRegisters::YResolution, this->_Y_resolution);
+    }
+    if (applied & IQS_CONFIG_XY_CONFIG_0)
+    {
+        this->queueWrite(IQSRegisters::XYConfig0, this->_xyConfig0);
+    }
+    if (applied & IQS_CONFIG_MAX_FINGERS)
+    {
+        this->queueWrite(IQSRegisters::MaxMultiTouches, this->_maxFingers);
+    }
+    if (applied & IQS_CONFIG_REPORT_RATE)
+    {
+        this->queueWrite(IQSRegisters::ActiveModeReportRate, this->_reportRate);
+    }
+    this->_setDefaultReadAddress(IQSRegisters::SingleFingerGestures);
+}
+
+void IQSTouchpad::_onShowReset(bool showReset)
 {
-    // add this touchpad to the list of touchpads
-    IQSTouchpad::_touchpads.push_back(this);
+    if (!showReset)
+    {
+        this->_chipResetHandled = false;
+        this->_resetExpected = false;
+        return;
+    }
+
+    // SHOW_RESET stays set in every frame until ACK_RESET is written
+    if (!this->_resetAckPending)
+    {
+        this->_resetAckPending = true;
+        auto callback = [this](int, byte)
+        {
+            // acknowledge again if the next frame still shows the reset
+            this->_resetAckPending = false;
+        };
+        this->queueWrite(IQSRegisters::SystemControl0, IQS_SYSTEM_CONTROL_ACK_RESET, callback);
+    }
+
+    if (this->_chipResetHandled)
+    {
+        return;
+    }
+    this->_chipResetHandled = true;
+    if (this->_resetExpected)
+    {
+        // reset() has already queued the configuration
+        this->_resetExpected = false;
+        return;
+    }
 
+    // the chip reset on its own: it runs on its defaults, whatever the
+    // shadow says
+    this->_chipResets++;
+    this->_shadow.forgetAll();
+    this->_queueConfiguration();
+}
 
+void IQSTouchpad::_begin()
+{
     pinMode(this->_PIN_RDY, INPUT);
     pinMode(this->_PIN_RST, OUTPUT);
 
-    // reset the touchpad
-    this->reset();
-
     // attach interrupt to RDY pin
-    attachInterrupt(digitalPinToInterrupt(this->_PIN_RDY), IQSInterrupt::IQSInterruptHandler, CHANGE);
+    this->_attachReadyInterrupt();
+
+    // reset the touchpad, update() brings it up
+    this->reset();
 }
 
 void IQSTouchpad::begin()
@@ -341,196 +536,1361 @@ void IQSTouchpad::begin(uint32_t frequency)
 {
     Wire.begin();
     Wire.setClock(frequency);
+    this->_profileWindowLimit = IQSProfile::windowBytes(frequency);
     this->_begin();
 }
 
 void IQSTouchpad::endCommunicationWindow()
 {
     // end communication window
-    byte error = I2CHelpers::endCommunication(this->_i2cAddress);
+    I2CHelpers::endCommunication(this->_i2cAddress);
 }
 
 void IQSTouchpad::update()
 {
-    if (this->_ready)
+    if (this->_windowState == WINDOW_IDLE)
     {
-        if (this->_initialized)
-        {
-            // update all touch data
-            // this must be the first thing in the communication window, since
-            // it relies on using the default read address for faster communication
-
-
-            // mandatory reads
-
-            // the number of mandatory reads should be as small as possible
-            // since more reads increases the minimum achievable cycle time
-
-            /*
-             * Read the following registers:
-             * - Single touch gestures
-             * - Multi touch gestures
-             * - System info 0
-             * - System info 1
-             * - Number of fingers
-             *
-             * - Relative X (only valid if number of fingers = 1)
-             * - Relative Y (only valid if number of fingers = 1)
-             *
-             * - Then the data for each finger 0, 1, 2, 3, 4 (if present):
-             *   - Absolute X
-             *   - Absolute Y
-             *   - Touch Strength
-             *   - Touch Area
-             *   - (Relative X is calculated from the previous Absolute X)
-             *   - (Relative Y is calculated from the previous Absolute Y)
-             *
-             */
-
-            // moreover, the touchpad must be initialized (the write queue
-            // has been cleared at least once) so that the default read address
-            // has been set
-            this->_readTouchData();
-
-
-            // check the queue for any pending reads, and apply all of them
-            while (!this->_readQueue.empty())
-            {
-                IQSRead read = this->_readQueue.front();
-
-                // read the value from the register
-                byte error;
-                int value = read.reg->read(read.i2cAddress, error);
-                read.callback(read.i2cAddress, read.reg->getAddress(), value, error);
-
-                // remove the read from the queue
-                this->_readQueue.pop();
-            }
-        }
-
-        // check the queue for any pending writes, and apply all of them
-        while (!this->_writeQueue.empty())
+        if (this->_updateReset() || !this->_ready)
         {
-            IQSWrite write = this->_writeQueue.front();
-
-            // write the value to the register
-            byte error = write.reg->write(write.i2cAddress, write.valueToWrite);
-            write.callback(write.i2cAddress, write.reg->getAddress(), error);
-
-            // remove the write from the queue
-            this->_writeQueue.pop();
+            // set updated flag
+            this->_wasUpdated = false;
+            this->_numEvents = 0;
+            return;
         }
 
-        // the touchpad must clear the write queue at least once
-        // before it is initialized
-        if (!this->_initialized)
+        this->_numEvents = 0;
+        this->_wasUpdated = false;
+        IQS_INSTRUMENT(
+            this->_windowOpenMicros = micros();
+            this->_latency.readyToOpen.add(this->_windowOpenMicros - this->_readyMicros);
+        )
+
+        // update all touch data
+        // this must be the first thing in the communication window, since
+        // it relies on using the default read address for faster communication
+        //
+        // the touchpad must be initialized (the write queue has been cleared
+        // at least once) so that the default read address has been set
+        if (this->_initialized)
         {
-            // set the initialized flag
-            this->_initialized = true;
-            // set updated flag
-            this->_wasUpdated = false;
+            this->_startFrameRead();
         }
         else
         {
-            // set updated flag
-            this->_wasUpdated = true;
+            this->_planWrites();
         }
-
-        // end communication window
-        this->endCommunicationWindow();
-
-        // reset ready flag
-        this->_ready = false;
     }
     else
     {
-        // set updated flag
         this->_wasUpdated = false;
     }
 
+    this->_runWindow();
 }
 
-void IQSTouchpad::_readTouchData()
+bool IQSTouchpad::beginAcquisitionTask(int core, int priority)
 {
-    // perform a current address (default address) read
-    //
-    // if the touchpad is not initialized, this will fail
-    //
-    // this starts at address 0x000D and reads up to 44 bytes
-
-    // the number of bytes to read depends on the max finger setting
+    this->setFrameBuffering(true);
+    return this->_task.start(IQSTouchpad::_acquisitionMain, this, "IQSTouchpad", core, priority);
+}
 
-    // 9 bytes for gestures and info, 7 bytes per finger
-    int bytes_to_read = 9 + 7 * this->_maxFingers;
+void IQSTouchpad::endAcquisitionTask()
+{
+    this->_task.stop();
+}
 
-    byte error = I2CHelpers::readFromCurrentAddress(this->_i2cAddress, bytes_to_read, this->_finger_data_buffer);
+void IQSTouchpad::_acquisitionMain(void* touchpad)
+{
+    IQSTouchpad* self = static_cast<IQSTouchpad*>(touchpad);
 
-    if (error != 0) { return; }
+    do
+    {
+        self->update();
+        // non-blocking backends need polling until the window is done. the
+        // task usually runs above loop(), so sleep between polls rather
+        // than spin
+        while (self->windowInProgress())
+        {
+            self->_task.pause();
+            self->update();
+        }
+    }
+    // the timeout only matters if an edge is missed, so it can be generous
+    while (self->_task.wait(100));
+}
 
-    int buffer_index = 0;
+void IQSTouchpad::setBusBackend(IQSBusBackend* backend)
+{
+    if (this->_windowState != WINDOW_IDLE)
+    {
+        return;
+    }
+    this->_bus = backend != nullptr ? backend : &IQSWire;
+}
 
-    // the next byte is the single finger gestures
-    byte single_finger_gestures = this->_finger_data_buffer[buffer_index++];
-    this->_TAP = I2CHelpers::getBit(single_finger_gestures, 0);
-    this->_PRESS_AND_HOLD = I2CHelpers::getBit(single_finger_gestures, 1);
-    this->_SWIPE_X_POS = I2CHelpers::getBit(single_finger_gestures, 2);
-    this->_SWIPE_X_NEG = I2CHelpers::getBit(single_finger_gestures, 3);
-    this->_SWIPE_Y_POS = I2CHelpers::getBit(single_finger_gestures, 4);
-    this->_SWIPE_Y_NEG = I2CHelpers::getBit(single_finger_gestures, 5);
+bool IQSTouchpad::windowInProgress()
+{
+    return this->_windowState != WINDOW_IDLE;
+}
 
-    // the next byte is the multi finger gestures
-    byte multi_finger_gestures = this->_finger_data_buffer[buffer_index++];
-    this->_TWO_FINGER_TAP = I2CHelpers::getBit(multi_finger_gestures, 0);
-    this->_SCROLL = I2CHelpers::getBit(multi_finger_gestures, 1);
-    this->_ZOOM = I2CHelpers::getBit(multi_finger_gestures, 2);
+void IQSTouchpad::setCapture(IQSCaptureWriter* capture)
+{
+    this->_capture = capture;
+}
 
-    // the next two bytes are system info
-    byte system_info_0 = this->_finger_data_buffer[buffer_index++]; // unused
-    byte system_info_1 = this->_finger_data_buffer[buffer_index++];
+void IQSTouchpad::_startTransaction(byte i2cAddress, const byte* tx, int txLength, byte* rx, int rxLength)
+{
+    this->_transaction.i2cAddress = i2cAddress;
+    this->_transaction.tx = tx;
+    this->_transaction.txLength = txLength;
+    this->_transaction.rx = rx;
+    this->_transaction.rxLength = rxLength;
+    this->_transaction.error = 0;
+    this->_transaction.done = false;
+    IQS_INSTRUMENT(this->_windowTransactions++; this->_windowBytes += txLength + rxLength;)
+    this->_transactionWaiting = !this->_bus->submit(this->_transaction);
+}
 
-    this->_TP_MOVEMENT = I2CHelpers::getBit(system_info_1, 0);
-    this->_PALM_DETECT = I2CHelpers::getBit(system_info_1, 1);
-    this->_TOO_MANY_FINGERS = I2CHelpers::getBit(system_info_1, 2);
-    this->_RR_MISSED = I2CHelpers::getBit(system_info_1, 3);
-    this->_SNAP_TOGGLE = I2CHelpers::getBit(system_info_1, 4);
-    this->_SWITCH_STATE = I2CHelpers::getBit(system_info_1, 5);
+bool IQSTouchpad::_transactionDone()
+{
+    if (this->_transactionWaiting)
+    {
+        // another touchpad had the bus, try again
+        this->_transactionWaiting = !this->_bus->submit(this->_transaction);
+        if (this->_transactionWaiting)
+        {
+            return false;
+        }
+    }
+    this->_bus->poll();
+    return this->_transaction.done;
+}
 
-    // the next byte is the number of fingers
-    this->_numFingers = this->_finger_data_buffer[buffer_index++];
+void IQSTouchpad::_runWindow()
+{
+    // advance as far as the bus allows without waiting: every completed
+    // transaction starts the next one, and a blocking backend completes
+    // them all in this one call
+    while (this->_windowState != WINDOW_IDLE && this->_transactionDone())
+    {
+        this->_completeTransaction();
+    }
+}
 
-    // if the number of fingers is 0 or there are too many, we are done
-    if (this->_numFingers == 0 || this->_TOO_MANY_FINGERS)
+void IQSTouchpad::_abortWindow()
+{
+    if (this->_windowState == WINDOW_IDLE)
     {
-        // update all fingers to be inactive
-        for (int i = 0; i < 5; i++)
+        return;
+    }
+    if (!this->_transactionWaiting)
+    {
+        this->_bus->abort(this->_transaction);
+    }
+    // the requests drained for this window are dropped with it, and the
+    // device ends the window itself once its I2C timeout expires
+    this->_transactionWaiting = false;
+    this->_windowState = WINDOW_IDLE;
+    this->_ready = false;
+}
+
+void IQSTouchpad::_completeTransaction()
+{
+    IQS_INSTRUMENT(
+        byte error = this->_transaction.error;
+        if (error != 0)
         {
-            this->_fingers[i].update(false, 0, 0, 0, 0);
+            this->_stats.errors[std::min((int)error, IQS_STATS_ERROR_CODES - 1)]++;
         }
+    )
 
-        return;
+    switch (this->_windowState)
+    {
+        case WINDOW_FRAME:
+            this->_completeFrameRead();
+            break;
+        case WINDOW_READS:
+            this->_completeReadBurst();
+            break;
+        case WINDOW_SHADOW:
+            this->_completeShadowFill();
+            break;
+        case WINDOW_WRITES:
+            this->_completeWriteBurst();
+            break;
+        case WINDOW_PROFILE:
+            this->_completeProfileBurst();
+            break;
+        case WINDOW_END:
+            this->_completeWindow();
+            break;
+        default:
+            break;
     }
+}
+
+void IQSTouchpad::_startFrameRead()
+{
+    // mandatory reads
 
+    // the number of mandatory reads should be as small as possible
+    // since more reads increases the minimum achievable cycle time
 
-    // the next 4 bytes are relative X and Y for finger 1
-    // since we calculate this from the previous absolute X and Y,
-    // we don't need to read it
-    buffer_index += 4;
+    /*
+     * Read the following registers with one current address (default
+     * address) read, starting at 0x000D:
+     * - Single touch gestures
+     * - Multi touch gestures
+     * - System info 0
+     * - System info 1
+     * - Number of fingers
+     *
+     * - Relative X (only valid if number of fingers = 1)
+     * - Relative Y (only valid if number of fingers = 1)
+     *
+     * - Then the data for each finger 0, 1, 2, 3, 4 (if present):
+     *   - Absolute X
+     *   - Absolute Y
+     *   - Touch Strength
+     *   - Touch Area
+     *   - (Relative X is calculated from the previous Absolute X)
+     *   - (Relative Y is calculated from the previous Absolute Y)
+     *
+     */
 
-    // the final chunk of the data is 7 bytes for each finger,
-    // 2 each for absolute X and Y, 2 for touch strength, and one for touch area
+    // the number of bytes to read depends on the max finger setting
 
-    // update the data for each finger
-    for (int i = 0; i < this->_numFingers; i++)
+    // 9 bytes for gestures and info, 7 bytes per finger
+    int max_fingers = this->_maxFingers;
+    if (max_fingers > 5) { max_fingers = 5; }
+    if (max_fingers < 0) { max_fingers = 0; }
+
+    // in adaptive mode, only read as many finger slots as recent frames
+    // needed. if more fingers turn up, the rest is fetched with a
+    // continuation read, which picks up at the auto-incremented address
+    int slots_to_read = max_fingers;
+    if (this->_adaptiveReadLength)
     {
-        int x = (this->_finger_data_buffer[buffer_index++] << 8) | this->_finger_data_buffer[buffer_index++];
-        int y = (this->_finger_data_buffer[buffer_index++] << 8) | this->_finger_data_buffer[buffer_index++];
-        int strength = (this->_finger_data_buffer[buffer_index++] << 8) | this->_finger_data_buffer[buffer_index++];
-        int area = this->_finger_data_buffer[buffer_index++];
-        this->_fingers[i].update(area > 0, x, y, strength, area);
+        slots_to_read = 0;
+        for (int i = 0; i < IQS_FINGER_HISTORY_LENGTH; i++)
+        {
+            slots_to_read = std::max(slots_to_read, (int)this->_fingerHistory[i]);
+        }
+        slots_to_read = std::min(slots_to_read, max_fingers);
     }
-    // update all remaining fingers to be inactive
-    for (int i = this->_numFingers; i < 5; i++)
+
+    this->_windowState = WINDOW_FRAME;
+    this->_frameSlots = slots_to_read;
+    this->_frameContinued = false;
+    this->_startTransaction(this->_i2cAddress, nullptr, 0, this->_finger_data_buffer, 9 + 7 * slots_to_read);
+}
+
+void IQSTouchpad::_completeFrameRead()
+{
+    if (this->_transaction.error != 0)
     {
-        this->_fingers[i].update(false, 0, 0, 0, 0);
+        // no frame this window, still serve the queues
+        this->_planReads();
+        return;
+    }
+
+    if (this->_adaptiveReadLength && !this->_frameContinued)
+    {
+        int max_fingers = std::max(0, std::min(this->_maxFingers, 5));
+        int reported = std::min((int)this->_finger_data_buffer[4], max_fingers);
+        bool too_many = I2CHelpers::getBit(this->_finger_data_buffer[3], 2);
+
+        this->_fingerHistory[this->_fingerHistoryIndex] = too_many ? 0 : reported;
+        this->_fingerHistoryIndex = (this->_fingerHistoryIndex + 1) % IQS_FINGER_HISTORY_LENGTH;
+
+        if (!too_many && reported > this->_frameSlots)
+        {
+            this->_frameContinued = true;
+            this->_startTransaction(this->_i2cAddress, nullptr, 0, this->_finger_data_buffer + 9 + 7 * this->_frameSlots, 7 * (reported - this->_frameSlots));
+            return;
+        }
+    }
+
+    this->_frameLength = 9 + 7 * this->_frameSlots + (this->_frameContinued ? this->_transaction.rxLength : 0);
+    if (this->_capture != nullptr)
+    {
+        this->_capture->frame(this->_readyMicros, this->_finger_data_buffer, this->_frameLength);
+    }
+
+    this->_decodeTouchData();
+    this->_buildEvents();
+    this->_pushFrame();
+    IQS_INSTRUMENT(this->_latency.openToDecoded.add(this->_lastFrame.decoded - this->_windowOpenMicros);)
+
+    this->_planReads();
+}
+
+void IQSTouchpad::_startEndWindow()
+{
+    // the command has to come from RAM for DMA backends
+    this->_windowState = WINDOW_END;
+    I2CHelpers::intToTwoByteArray(END_COMM_REG, this->_txBuffer);
+    this->_txBuffer[2] = 'a';
+    this->_startTransaction(this->_i2cAddress, this->_txBuffer, 3, nullptr, 0);
+}
+
+void IQSTouchpad::_completeWindow()
+{
+    // the touchpad must clear the write queue at least once
+    // before it is initialized
+    if (!this->_initialized)
+    {
+        // set the initialized flag
+        this->_initialized = true;
+        // set updated flag
+        this->_wasUpdated = false;
+    }
+    else
+    {
+        // set updated flag
+        this->_wasUpdated = true;
+    }
+
+    // reset ready flag
+    this->_windowState = WINDOW_IDLE;
+    this->_ready = false;
+
+    IQS_INSTRUMENT(uint32_t dispatchStart = micros();)
+    // subscribers run outside the window, so they cannot hold it open
+    this->_dispatchEvents();
+
+    IQS_INSTRUMENT(
+        uint32_t now = micros();
+        IQSWindowStats& stats = this->_stats;
+        stats.windows++;
+        stats.transactions.add(this->_windowTransactions);
+        stats.bytes.add(this->_windowBytes);
+        stats.duration.add(now - this->_readyMicros);
+        stats.callbackMicros.add(this->_windowCallbackMicros + (now - dispatchStart));
+        this->_windowTransactions = 0;
+        this->_windowBytes = 0;
+        this->_windowCallbackMicros = 0;
+    )
+}
+
+IQSWindowStats IQSTouchpad::windowStats()
+{
+#if IQS_INSTRUMENTATION
+    return this->_stats;
+#else
+    return IQSWindowStats();
+#endif
+}
+
+void IQSTouchpad::resetWindowStats()
+{
+    IQS_INSTRUMENT(this->_stats = IQSWindowStats();)
+}
+
+void IQSTouchpad::acknowledgeFrame(const IQSFrame& frame)
+{
+    // only instrumentation looks at the frame
+    (void)frame;
+    IQS_INSTRUMENT(
+        uint32_t now = micros();
+        this->_latency.decodedToAck.add(now - frame.decoded);
+        this->_latency.readyToAck.add(now - frame.timestamp);
+    )
+}
+
+void IQSTouchpad::acknowledgeFrame()
+{
+    this->acknowledgeFrame(this->_lastFrame);
+}
+
+const IQSLatencyStats& IQSTouchpad::latencyStats()
+{
+#if IQS_INSTRUMENTATION
+    return this->_latency;
+#else
+    static const IQSLatencyStats empty;
+    return empty;
+#endif
+}
+
+void IQSTouchpad::resetLatencyStats()
+{
+    IQS_INSTRUMENT(this->_latency = IQSLatencyStats();)
+}
+
+void IQSTouchpad::printLatency(Print& out)
+{
+    this->latencyStats().printTo(out);
+}
+
+void IQSTouchpad::setAdaptiveReadLength(bool enabled)
+{
+    this->_adaptiveReadLength = enabled;
+    // start from the worst case, shrink as frames come in
+    for (int i = 0; i < IQS_FINGER_HISTORY_LENGTH; i++)
+    {
+        this->_fingerHistory[i] = 5;
+    }
+}
+
+void IQSTouchpad::setReadGapTolerance(int bytes)
+{
+    this->_readGapTolerance = bytes < 0 ? 0 : bytes;
+}
+
+int IQSTouchpad::onFrame(IQSFrameCallback callback)
+{
+    for (int i = 0; i < IQS_MAX_FRAME_SUBSCRIBERS; i++)
+    {
+        if (!this->_frameSubscribers[i])
+        {
+            this->_frameSubscribers[i] = callback;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void IQSTouchpad::removeOnFrame(int handle)
+{
+    if (handle >= 0 && handle < IQS_MAX_FRAME_SUBSCRIBERS)
+    {
+        this->_frameSubscribers[handle] = nullptr;
+    }
+}
+
+const IQSTouchEvent* IQSTouchpad::getEvents(int& count)
+{
+    count = this->_numEvents;
+    return this->_events;
+}
+
+void IQSTouchpad::_buildEvents()
+{
+    // diff the frame just decoded against the previous one: one event per
+    // finger that went down, moved (or changed force/area) or went up, and
+    // one per gesture bit that was raised
+    this->_numEvents = 0;
+
+    for (int i = 0; i < 5; i++)
+    {
+        const Finger& finger = this->_fingers[i];
+        FingerState& previous = this->_previousFingers[i];
+
+        // a slot that changed hands (finger tracking) lifts the old finger
+        // and puts the new one down in the same frame
+        bool replaced = (this->_fingersReplaced & (1 << i)) && previous.is_touching;
+        if (replaced)
+        {
+            IQSTouchEvent& event = this->_events[this->_numEvents++];
+            event.type = FINGER_UP;
+            event.finger = i;
+            event.changed = 0;
+            event.x = previous.x;
+            event.y = previous.y;
+            event.force = previous.force;
+            event.area = previous.area;
+            event.gesture = 0;
+        }
+
+        byte type;
+        byte changed = 0;
+        if (finger.is_touching && (!previous.is_touching || replaced))
+        {
+            type = FINGER_DOWN;
+            changed = IQS_CHANGED_X | IQS_CHANGED_Y | IQS_CHANGED_FORCE | IQS_CHANGED_AREA;
+        }
+        else if (!finger.is_touching && previous.is_touching)
+        {
+            type = FINGER_UP;
+        }
+        else if (finger.is_touching)
+        {
+            type = FINGER_MOVE;
+            if (finger.x != previous.x)         { changed |= IQS_CHANGED_X; }
+            if (finger.y != previous.y)         { changed |= IQS_CHANGED_Y; }
+            if (finger.force != previous.force) { changed |= IQS_CHANGED_FORCE; }
+            if (finger.area != previous.area)   { changed |= IQS_CHANGED_AREA; }
+            if (changed == 0) { continue; }
+        }
+        else
+        {
+            continue;
+        }
+
+        // a lifted finger reports where it was last seen
+        const bool up = type == FINGER_UP;
+        IQSTouchEvent& event = this->_events[this->_numEvents++];
+        event.type = type;
+        event.finger = i;
+        event.changed = changed;
+        event.x = up ? previous.x : finger.x;
+        event.y = up ? previous.y : finger.y;
+        event.force = up ? previous.force : finger.force;
+        event.area = up ? previous.area : finger.area;
+        event.gesture = 0;
+
+        previous.is_touching = finger.is_touching;
+        previous.x = finger.x;
+        previous.y = finger.y;
+        previous.force = finger.force;
+        previous.area = finger.area;
+    }
+
+    uint16_t raised = this->_gestures & ~this->_previousGestures;
+    this->_previousGestures = this->_gestures;
+    while (raised != 0 && this->_numEvents < IQS_MAX_FRAME_EVENTS)
+    {
+        uint16_t bit = raised & -raised;
+        raised &= ~bit;
+
+        IQSTouchEvent& event = this->_events[this->_numEvents++];
+        event.type = GESTURE;
+        event.finger = 0;
+        event.changed = 0;
+        event.x = 0;
+        event.y = 0;
+        event.force = 0;
+        event.area = 0;
+        event.gesture = bit;
+    }
+}
+
+void IQSTouchpad::setFrameBuffering(bool enabled)
+{
+    this->_frameBuffering = enabled;
+}
+
+int IQSTouchpad::framesAvailable()
+{
+    return this->_frames.size();
+}
+
+bool IQSTouchpad::peekFrame(IQSFrame& frame)
+{
+    return this->_frames.peek(frame);
+}
+
+bool IQSTouchpad::readFrame(IQSFrame& frame)
+{
+    return this->_frames.pop(frame);
+}
+
+int IQSTouchpad::drainFrames(IQSFrame* frames, int maxFrames)
+{
+    int count = 0;
+    while (count < maxFrames && this->_frames.pop(frames[count]))
+    {
+        count++;
+    }
+    return count;
+}
+
+void IQSTouchpad::_pushFrame()
+{
+    // every decoded frame gets a sequence number, even if it is dropped
+    IQSFrame& frame = this->_lastFrame;
+    frame.sequence = this->_frameSequence++;
+    frame.timestamp = this->_readyMicros;
+    frame.decoded = micros();
+    frame.gestures = this->_gestures;
+    frame.systemInfo0 = this->_systemInfo0;
+    frame.systemInfo1 = this->_systemInfo1;
+    frame.replaced = this->_fingersReplaced;
+    frame.numFingers = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        const Finger& finger = this->_fingers[i];
+        if (finger.is_touching)
+        {
+            frame.numFingers++;
+        }
+        frame.x[i] = finger.x;
+        frame.y[i] = finger.y;
+        frame.force[i] = finger.force;
+        frame.area[i] = finger.area;
+    }
+
+    if (!this->_frameBuffering)
+    {
+        return;
+    }
+
+    // keep the older frames, they hold input the application has not seen
+    if (!this->_frames.push(frame))
+    {
+        this->_framesDropped++;
+    }
+}
+
+void IQSTouchpad::_dispatchEvents()
+{
+    if (this->_numEvents == 0)
+    {
+        return;
+    }
+    for (int i = 0; i < IQS_MAX_FRAME_SUBSCRIBERS; i++)
+    {
+        if (this->_frameSubscribers[i])
+        {
+            this->_frameSubscribers[i](*this, this->_events, this->_numEvents);
+        }
+    }
+}
+
+namespace
+{
+    // stable insertion sort of request indices by device and register
+    // address. the queues are short, and unlike std::stable_sort this never
+    // asks for a temporary buffer
+    template <typename T>
+    void sortByAddress(T* requests, int* order, int count)
+    {
+        for (int i = 1; i < count; i++)
+        {
+            int current = order[i];
+            int j = i - 1;
+            while (j >= 0 &&
+                   (requests[order[j]].i2cAddress > requests[current].i2cAddress ||
+                    (requests[order[j]].i2cAddress == requests[current].i2cAddress &&
+                     requests[order[j]].reg.address > requests[current].reg.address)))
+            {
+                order[j + 1] = order[j];
+                j--;
+            }
+            order[j + 1] = current;
+        }
+    }
+}
+
+void IQSTouchpad::_planReads()
+{
+    // drain the queue, then plan the fewest burst reads that cover every
+    // pending read: reads are sorted by address, and the next read joins the
+    // current burst if the gap between them is at most _readGapTolerance
+    // bytes (skipping a few bytes is cheaper than a new address phase and
+    // repeated start) and the burst still fits in the Wire buffer. each
+    // register's slice of the burst is decoded with its own data type, and
+    // callbacks run in the order the reads were queued
+
+    this->_windowState = WINDOW_READS;
+
+    IQSRead* reads = this->_reads;
+    int numReads = 0;
+    // bounded, since producers can refill the queue while it drains
+    while (numReads < IQS_READ_QUEUE_DEPTH && this->_readQueue.pop(reads[numReads]))
+    {
+        numReads++;
+    }
+    this->_numQueuedReads = numReads;
+    IQS_INSTRUMENT(
+        this->_stats.readsDrained.add(numReads);
+        // sample the chip's cycle time now and then, if there is room
+        if (this->_stats.windows % IQS_CYCLE_TIME_SAMPLE_PERIOD == 0 && numReads < IQS_READ_QUEUE_DEPTH)
+        {
+            auto sample = [this](int, int, int readValue, byte returnCode)
+            {
+                if (returnCode == 0)
+                {
+                    this->_stats.cycleTime.add(readValue);
+                }
+            };
+            reads[numReads++] = IQSRead { this->_i2cAddress, IQSRegisters::PreviousCycleTime->getInfo(), sample };
+        }
+    )
+    this->_numReads = numReads;
+    this->_numReadsOrdered = 0;
+
+    for (int i = 0; i < numReads; i++)
+    {
+        const IQSRegisterInfo& reg = reads[i].reg;
+        this->_readValues[i] = 0;
+        this->_readErrors[i] = 0;
+        if (reg.mode == 'w')
+        {
+            // cannot read from a write-only register
+            this->_readErrors[i] = 8;
+        }
+        else if (reg.numBytes < 1 || reg.numBytes > IQS_I2C_BUFFER_LENGTH)
+        {
+            this->_readErrors[i] = 9;
+        }
+        else
+        {
+            this->_readOrder[this->_numReadsOrdered++] = i;
+        }
+    }
+
+    sortByAddress(reads, this->_readOrder, this->_numReadsOrdered);
+
+    this->_burstFirst = 0;
+    this->_startReadBurst();
+}
+
+void IQSTouchpad::_startReadBurst()
+{
+    const IQSRead* reads = this->_reads;
+    const int* order = this->_readOrder;
+    int first = this->_burstFirst;
+    int numOrdered = this->_numReadsOrdered;
+
+    if (first >= numOrdered)
+    {
+        IQS_INSTRUMENT(uint32_t callbackStart = micros();)
+        for (int i = 0; i < this->_numReads; i++)
+        {
+            if (this->_capture != nullptr && i < this->_numQueuedReads)
+            {
+                this->_capture->read(reads[i].reg.address, reads[i].reg.numBytes, this->_readValues[i], this->_readErrors[i]);
+            }
+            this->_reads[i].callback(reads[i].i2cAddress, reads[i].reg.address, this->_readValues[i], this->_readErrors[i]);
+            // release the callback's captures now rather than next window
+            this->_reads[i].callback = nullptr;
+        }
+        IQS_INSTRUMENT(this->_windowCallbackMicros += micros() - callbackStart;)
+        this->_planWrites();
+        return;
+    }
+
+    int start = reads[order[first]].reg.address;
+    int end = start + reads[order[first]].reg.numBytes;
+
+    int last = first + 1;
+    while (last < numOrdered)
+    {
+        const IQSRegisterInfo& reg = reads[order[last]].reg;
+        int nextEnd = std::max(end, reg.address + reg.numBytes);
+        if (reads[order[last]].i2cAddress != reads[order[first]].i2cAddress ||
+            reg.address - end > this->_readGapTolerance ||
+            nextEnd - start > IQS_I2C_BUFFER_LENGTH)
+        {
+            break;
+        }
+        end = nextEnd;
+        last++;
+    }
+
+    this->_burstLast = last;
+    this->_burstStart = start;
+    I2CHelpers::intToTwoByteArray(start, this->_txBuffer);
+    this->_startTransaction(reads[order[first]].i2cAddress, this->_txBuffer, 2, this->_rxBuffer, end - start);
+}
+
+void IQSTouchpad::_completeReadBurst()
+{
+    byte error = this->_transaction.error;
+    for (int k = this->_burstFirst; k < this->_burstLast; k++)
+    {
+        int i = this->_readOrder[k];
+        this->_readErrors[i] = error;
+        if (error == 0)
+        {
+            const IQSRegisterInfo& reg = this->_reads[i].reg;
+            this->_readValues[i] = IQSRegister::decode(reg, this->_rxBuffer + reg.address - this->_burstStart, this->_readErrors[i]);
+        }
+    }
+    if (error == 0 && this->_transaction.i2cAddress == this->_i2cAddress)
+    {
+        this->_shadow.set(this->_burstStart, this->_rxBuffer, this->_transaction.rxLength);
+    }
+
+    this->_burstFirst = this->_burstLast;
+    this->_startReadBurst();
+}
+
+void IQSTouchpad::_planWrites()
+{
+    // drain the queue, then apply the writes as the fewest possible block
+    // writes: pending writes are sorted by address, and writes that touch or
+    // overlap are merged into one burst (up to the Wire buffer size). where
+    // writes overlap, the most recently queued value wins. every original
+    // callback still gets its own register address and the error code of
+    // the burst that carried it, in the order the writes were queued.
+    // before that, registers the shadow is missing are read into it, so
+    // that modifies can be resolved and no-op writes dropped
+
+    IQSWrite* writes = this->_writes;
+    int numWrites = 0;
+    // bounded, since producers can refill the queue while it drains
+    while (numWrites < IQS_WRITE_QUEUE_DEPTH && this->_writeQueue.pop(writes[numWrites]))
+    {
+        numWrites++;
+    }
+    IQS_INSTRUMENT(this->_stats.writesDrained.add(numWrites);)
+    this->_numWrites = numWrites;
+    this->_numWritesOrdered = 0;
+
+    for (int i = 0; i < numWrites; i++)
+    {
+        const IQSRegisterInfo& reg = writes[i].reg;
+        this->_writeErrors[i] = 0;
+        if (reg.mode == 'r')
+        {
+            // cannot write to a read-only register
+            this->_writeErrors[i] = 8;
+        }
+        else if (reg.numBytes != 1 && reg.numBytes != 2)
+        {
+            // unimplemented
+            this->_writeErrors[i] = 9;
+        }
+        else if (writes[i].modifyMask != 0 && !IQSShadowRegisters::covers(reg.address, reg.numBytes))
+        {
+            // error code 7: refused, the rest of the register is unknown
+            this->_writeErrors[i] = 7;
+        }
+        else
+        {
+            this->_writeOrder[this->_numWritesOrdered++] = i;
+            if (writes[i].modifyMask != 0 && !this->_shadow.known(reg.address, reg.numBytes))
+            {
+                this->_shadow.want(reg.address, reg.numBytes);
+            }
+        }
+    }
+
+    if (this->_shadowLoadRequested)
+    {
+        this->_shadowLoadRequested = false;
+        this->_shadow.wantAll();
+    }
+
+    this->_windowState = WINDOW_SHADOW;
+    this->_shadowFillError = 0;
+    this->_startShadowFill();
+}
+
+void IQSTouchpad::_startShadowFill()
+{
+    int address;
+    int length;
+    if (!this->_shadow.nextWanted(address, length, IQS_I2C_BUFFER_LENGTH))
+    {
+        this->_resolveWrites();
+        return;
+    }
+
+    // read straight into the shadow
+    this->_shadowFillAddress = address;
+    this->_shadowFillLength = length;
+    I2CHelpers::intToTwoByteArray(address, this->_txBuffer);
+    this->_startTransaction(this->_i2cAddress, this->_txBuffer, 2, this->_shadow.data(address), length);
+}
+
+void IQSTouchpad::_completeShadowFill()
+{
+    byte error = this->_transaction.error;
+    if (error != 0)
+    {
+        this->_shadowFillError = error;
+    }
+    this->_shadow.filled(this->_shadowFillAddress, this->_shadowFillLength, error == 0);
+    this->_startShadowFill();
+}
+
+void IQSTouchpad::_resolveWrites()
+{
+    this->_windowState = WINDOW_WRITES;
+
+    IQSWrite* writes = this->_writes;
+    int* order = this->_writeOrder;
+    int numOrdered = this->_numWritesOrdered;
+
+    // resolve modifies in queue order (the order is still the queue order
+    // here), each on top of the shadow and any earlier write of the same
+    // register in this window
+    for (int k = 0; k < numOrdered; k++)
+    {
+        IQSWrite& write = writes[order[k]];
+        if (write.modifyMask == 0)
+        {
+            continue;
+        }
+        int base;
+        if (!this->_shadow.get(write.reg.address, write.reg.numBytes, base))
+        {
+            // the register could not be read, so neither can it be modified
+            this->_writeErrors[order[k]] = this->_shadowFillError != 0 ? this->_shadowFillError : IQS_ERROR_NOT_SHADOWED;
+            continue;
+        }
+        for (int j = 0; j < k; j++)
+        {
+            const IQSWrite& earlier = writes[order[j]];
+            if (this->_writeErrors[order[j]] == 0 &&
+                earlier.i2cAddress == write.i2cAddress &&
+                earlier.reg.address == write.reg.address &&
+                earlier.reg.numBytes == write.reg.numBytes)
+            {
+                base = earlier.valueToWrite;
+            }
+        }
+        write.valueToWrite = (base & ~write.modifyMask) | (write.valueToWrite & write.modifyMask);
+        write.modifyMask = 0;
+    }
+
+    // drop writes that failed to resolve, and writes of the value the chip
+    // already holds. a write that overlaps another one in this window is
+    // kept, since dropping it could change which value ends up on the chip
+    int kept = 0;
+    for (int k = 0; k < numOrdered; k++)
+    {
+        int i = order[k];
+        const IQSRegisterInfo& reg = writes[i].reg;
+        if (this->_writeErrors[i] != 0)
+        {
+            continue;
+        }
+
+        int current;
+        bool noop = writes[i].i2cAddress == this->_i2cAddress &&
+                    this->_shadow.get(reg.address, reg.numBytes, current) &&
+                    current == (writes[i].valueToWrite & (reg.numBytes == 1 ? 0xFF : 0xFFFF));
+        for (int j = 0; noop && j < numOrdered; j++)
+        {
+            const IQSRegisterInfo& other = writes[order[j]].reg;
+            if (j != k &&
+                other.address < reg.address + reg.numBytes &&
+                reg.address < other.address + other.numBytes)
+            {
+                noop = false;
+            }
+        }
+        if (noop)
+        {
+            this->_writesSuppressed++;
+            continue;
+        }
+        order[kept++] = i;
+    }
+    this->_numWritesOrdered = kept;
+
+    sortByAddress(writes, order, kept);
+
+    this->_burstFirst = 0;
+    this->_startWriteBurst();
+}
+
+void IQSTouchpad::_startWriteBurst()
+{
+    const IQSWrite* writes = this->_writes;
+    const int* order = this->_writeOrder;
+    int first = this->_burstFirst;
+    int numOrdered = this->_numWritesOrdered;
+
+    if (first >= numOrdered)
+    {
+        IQS_INSTRUMENT(uint32_t callbackStart = micros();)
+        for (int i = 0; i < this->_numWrites; i++)
+        {
+            if (this->_capture != nullptr)
+            {
+                this->_capture->write(writes[i].reg.address, writes[i].valueToWrite, this->_writeErrors[i]);
+            }
+            this->_writes[i].callback(writes[i].i2cAddress, writes[i].reg.address, this->_writeErrors[i]);
+            // release the callback's captures now rather than next window
+            this->_writes[i].callback = nullptr;
+        }
+        IQS_INSTRUMENT(this->_windowCallbackMicros += micros() - callbackStart;)
+        this->_profileWindowBytes = 0;
+        this->_startProfileBurst();
+        return;
+    }
+
+    int start = writes[order[first]].reg.address;
+    int end = start + writes[order[first]].reg.numBytes;
+
+    // extend the burst while the next write touches or overlaps it
+    int last = first + 1;
+    while (last < numOrdered)
+    {
+        const IQSRegisterInfo& reg = writes[order[last]].reg;
+        int nextEnd = std::max(end, reg.address + reg.numBytes);
+        if (writes[order[last]].i2cAddress != writes[order[first]].i2cAddress ||
+            reg.address > end || nextEnd - start > IQS_MAX_WRITE_BURST)
+        {
+            break;
+        }
+        end = nextEnd;
+        last++;
+    }
+
+    // assemble the burst after the register address, latest queued write
+    // winning each byte
+    byte* burst = this->_txBuffer + 2;
+    // index of the write that last set each byte of the burst
+    int owner[IQS_MAX_WRITE_BURST];
+    for (int j = 0; j < end - start; j++)
+    {
+        owner[j] = -1;
+    }
+    for (int k = first; k < last; k++)
+    {
+        int i = order[k];
+        const IQSRegisterInfo& reg = writes[i].reg;
+        byte value[2];
+        if (reg.numBytes == 1)
+        {
+            value[0] = writes[i].valueToWrite;
+        }
+        else
+        {
+            I2CHelpers::intToTwoByteArray(writes[i].valueToWrite, value);
+        }
+        for (int b = 0; b < reg.numBytes; b++)
+        {
+            int offset = reg.address - start + b;
+            if (i > owner[offset])
+            {
+                owner[offset] = i;
+                burst[offset] = value[b];
+            }
+        }
+    }
+
+    this->_burstLast = last;
+    this->_burstStart = start;
+    I2CHelpers::intToTwoByteArray(start, this->_txBuffer);
+    this->_startTransaction(writes[order[first]].i2cAddress, this->_txBuffer, 2 + end - start, nullptr, 0);
+}
+
+void IQSTouchpad::_completeWriteBurst()
+{
+    for (int k = this->_burstFirst; k < this->_burstLast; k++)
+    {
+        this->_writeErrors[this->_writeOrder[k]] = this->_transaction.error;
+    }
+
+    // the shadow follows what the chip holds. a failed write may or may not
+    // have landed
+    int length = this->_transaction.txLength - 2;
+    if (this->_transaction.i2cAddress == this->_i2cAddress)
+    {
+        if (this->_transaction.error == 0)
+        {
+            this->_shadow.set(this->_burstStart, this->_txBuffer + 2, length);
+        }
+        else
+        {
+            this->_shadow.forget(this->_burstStart, length);
+        }
+    }
+
+    this->_burstFirst = this->_burstLast;
+    this->_startWriteBurst();
+}
+
+void IQSTouchpad::_startProfileBurst()
+{
+    // the profile goes out after the queued writes, as block writes of
+    // contiguous records. once it is all written it is read back in blocks
+    // of the same size and compared, which also fills the shadow
+    int limit = this->_profileWindowLimit;
+    if (!this->_profilePending || (limit > 0 && this->_profileWindowBytes >= limit))
+    {
+        this->_startEndWindow();
+        return;
+    }
+
+    // the expected bytes sit after the register address in either case
+    int maxLength = IQS_MAX_WRITE_BURST;
+    if (limit > 0)
+    {
+        maxLength = std::min(maxLength, limit - this->_profileWindowBytes);
+    }
+    int address = 0;
+    int length = IQSProfile::gather(this->_profile, this->_profileLength, this->_profileCursor, address, this->_txBuffer + 2, maxLength);
+    if (length == 0)
+    {
+        if (this->_profileVerifying)
+        {
+            this->_finishProfile(0);
+            this->_startEndWindow();
+            return;
+        }
+        this->_profileVerifying = true;
+        this->_profileCursor = IQSProfileCursor {};
+        this->_startProfileBurst();
+        return;
+    }
+
+    this->_windowState = WINDOW_PROFILE;
+    this->_profileBurstLength = length;
+    this->_burstStart = address;
+    I2CHelpers::intToTwoByteArray(address, this->_txBuffer);
+    if (this->_profileVerifying)
+    {
+        this->_startTransaction(this->_i2cAddress, this->_txBuffer, 2, this->_rxBuffer, length);
+    }
+    else
+    {
+        this->_startTransaction(this->_i2cAddress, this->_txBuffer, 2 + length, nullptr, 0);
+    }
+}
+
+void IQSTouchpad::_completeProfileBurst()
+{
+    int length = this->_profileBurstLength;
+    byte error = this->_transaction.error;
+    this->_profileWindowBytes += length;
+
+    if (error != 0)
+    {
+        this->_shadow.forget(this->_burstStart, length);
+        this->_finishProfile(error);
+        this->_startEndWindow();
+        return;
+    }
+
+    if (!this->_profileVerifying)
+    {
+        this->_shadow.set(this->_burstStart, this->_txBuffer + 2, length);
+    }
+    else
+    {
+        this->_shadow.set(this->_burstStart, this->_rxBuffer, length);
+        for (int i = 0; i < length; i++)
+        {
+            // command and read-only bits need not read back as written
+            byte differs = this->_rxBuffer[i] ^ this->_txBuffer[2 + i];
+            if (differs & IQSProfile::verifyMask(this->_burstStart + i))
+            {
+                // error code 12: the chip does not hold what was written
+                this->_finishProfile(12);
+                this->_startEndWindow();
+                return;
+            }
+        }
+    }
+
+    this->_startProfileBurst();
+}
+
+void IQSTouchpad::_finishProfile(byte error)
+{
+    IQSProfileCallback callback = this->_profileCallback;
+    this->_profileCallback = nullptr;
+    this->_profile = nullptr;
+    this->_profilePending = false;
+    IQS_INSTRUMENT(uint32_t callbackStart = micros();)
+    callback(error);
+    IQS_INSTRUMENT(this->_windowCallbackMicros += micros() - callbackStart;)
+}
+
+void IQSTouchpad::_decodeTouchData()
+{
+    // the frame starts at address 0x000D (the default read address)
+    IQSRawFrame frame;
+    IQSDecode::frame(this->_finger_data_buffer, this->_frameLength, frame);
+
+    // single finger gestures, multi finger gestures and the system info
+    this->_gestures = frame.gestures;
+    this->_systemInfo0 = frame.systemInfo0;
+    this->_systemInfo1 = frame.systemInfo1;
+    this->_onShowReset((frame.systemInfo0 & IQS_SYSTEM_SHOW_RESET) != 0);
+
+    uint16_t gestures = frame.gestures;
+    this->_TAP = (gestures & IQS_GESTURE_TAP) != 0;
+    this->_PRESS_AND_HOLD = (gestures & IQS_GESTURE_PRESS_AND_HOLD) != 0;
+    this->_SWIPE_X_POS = (gestures & IQS_GESTURE_SWIPE_X_POS) != 0;
+    this->_SWIPE_X_NEG = (gestures & IQS_GESTURE_SWIPE_X_NEG) != 0;
+    this->_SWIPE_Y_POS = (gestures & IQS_GESTURE_SWIPE_Y_POS) != 0;
+    this->_SWIPE_Y_NEG = (gestures & IQS_GESTURE_SWIPE_Y_NEG) != 0;
+    this->_TWO_FINGER_TAP = (gestures & IQS_GESTURE_TWO_FINGER_TAP) != 0;
+    this->_SCROLL = (gestures & IQS_GESTURE_SCROLL) != 0;
+    this->_ZOOM = (gestures & IQS_GESTURE_ZOOM) != 0;
+
+    byte system_info_1 = frame.systemInfo1;
+    this->_TP_MOVEMENT = (system_info_1 & IQS_SYSTEM_TP_MOVEMENT) != 0;
+    this->_PALM_DETECT = (system_info_1 & IQS_SYSTEM_PALM_DETECT) != 0;
+    this->_TOO_MANY_FINGERS = (system_info_1 & IQS_SYSTEM_TOO_MANY_FINGERS) != 0;
+    this->_RR_MISSED = (system_info_1 & IQS_SYSTEM_RR_MISSED) != 0;
+    IQS_INSTRUMENT(this->_stats.reportRateMissed += this->_RR_MISSED;)
+    this->_SNAP_TOGGLE = (system_info_1 & IQS_SYSTEM_SNAP_TOGGLE) != 0;
+    this->_SWITCH_STATE = (system_info_1 & IQS_SYSTEM_SWITCH_STATE) != 0;
+
+    // the number of fingers as reported, frame.count is what was decoded
+    this->_numFingers = frame.numFingers;
+
+    // time since the previous frame, for the coordinate filter. fall back on
+    // the report rate if the RDY timestamp is missing
+    this->_filterDtMicros = this->_readyMicros - this->_previousFrameMicros;
+    this->_previousFrameMicros = this->_readyMicros;
+    if (this->_filterDtMicros == 0 || this->_filterDtMicros > 100000)
+    {
+        this->_filterDtMicros = (uint32_t)this->_reportRate * 1000;
+    }
+
+    int count = frame.count;
+    FingerState contacts[5];
+    for (int i = 0; i < count; i++)
+    {
+        contacts[i] = FingerState { frame.area[i] > 0, frame.x[i], frame.y[i], frame.strength[i], frame.area[i] };
+    }
+
+    this->_fingersReplaced = 0;
+    if (this->_fingerTracking)
+    {
+        this->_trackFingers(contacts, count);
+        return;
+    }
+
+    // update the data for each finger
+    for (int i = 0; i < count; i++)
+    {
+        this->_updateFinger(i, contacts[i]);
+    }
+    // update all remaining fingers to be inactive
+    for (int i = count; i < 5; i++)
+    {
+        this->_updateFinger(i, FingerState {});
+    }
+}
+
+void IQSTouchpad::_updateFinger(int slot, const FingerState& contact)
+{
+    // an empty slot that was already empty stays as it is
+    bool empty = !contact.is_touching && contact.x == 0 && contact.y == 0 && contact.force == 0 && contact.area == 0;
+    byte bit = 1 << slot;
+    if (empty && !(this->_fingersInUse & bit))
+    {
+        return;
+    }
+    this->_fingersInUse = empty ? this->_fingersInUse & ~bit : this->_fingersInUse | bit;
+
+    Finger& finger = this->_fingers[slot];
+    if (!contact.is_touching || !finger.is_touching)
+    {
+        // a finger that lands starts with fresh filters
+        this->_filterX[slot].reset();
+        this->_filterY[slot].reset();
+    }
+
+    int x = contact.x;
+    int y = contact.y;
+    if (contact.is_touching && this->_filterConfig.stages != 0)
+    {
+        x = this->_filterX[slot].apply(this->_filterConfig, x, this->_filterDtMicros, this->_X_resolution);
+        y = this->_filterY[slot].apply(this->_filterConfig, y, this->_filterDtMicros, this->_Y_resolution);
+    }
+    finger.update(contact.is_touching, x, y, contact.force, contact.area);
+}
+
+void IQSTouchpad::setFingerTracking(bool enabled, int maxDistance)
+{
+    this->_fingerTracking = enabled;
+    this->_trackingMaxDistance = maxDistance;
+}
+
+void IQSTouchpad::setFilter(const IQSFilterConfig& config)
+{
+    this->_filterConfig = config;
+    for (int i = 0; i < 5; i++)
+    {
+        this->_filterX[i].reset();
+        this->_filterY[i].reset();
+    }
+}
+
+void IQSTouchpad::_trackFingers(const FingerState* contacts, int count)
+{
+    // the IQS5xx reports no track IDs, so contacts are matched to the
+    // fingers of the previous frame greedily by distance: of all
+    // (finger, contact) pairs, the closest pair is matched first, then the
+    // closest of the remaining ones, and so on. with at most 5 of each that
+    // is a handful of passes over 25 squared distances. a finger keeps its
+    // slot (and so its id and relative motion) for as long as it is
+    // matched; new contacts take the lowest free slot
+
+    int64_t distance[5][5];
+    for (int f = 0; f < 5; f++)
+    {
+        for (int c = 0; c < count; c++)
+        {
+            int64_t dx = contacts[c].x - this->_fingers[f].x;
+            int64_t dy = contacts[c].y - this->_fingers[f].y;
+            distance[f][c] = dx * dx + dy * dy;
+        }
+    }
+
+    int64_t limit = (int64_t)this->_trackingMaxDistance * this->_trackingMaxDistance;
+    int slotOf[5] = { -1, -1, -1, -1, -1 };
+    bool fingerTaken[5] = {};
+    for (int matched = 0; matched < count; matched++)
+    {
+        int bestFinger = -1;
+        int bestContact = -1;
+        for (int f = 0; f < 5; f++)
+        {
+            if (fingerTaken[f] || !this->_fingers[f].is_touching)
+            {
+                continue;
+            }
+            for (int c = 0; c < count; c++)
+            {
+                if (slotOf[c] != -1 || (limit > 0 && distance[f][c] > limit))
+                {
+                    continue;
+                }
+                if (bestFinger == -1 || distance[f][c] < distance[bestFinger][bestContact])
+                {
+                    bestFinger = f;
+                    bestContact = c;
+                }
+            }
+        }
+        if (bestFinger == -1)
+        {
+            break;
+        }
+        fingerTaken[bestFinger] = true;
+        slotOf[bestContact] = bestFinger;
+    }
+
+    // new contacts take free slots (not held by a finger still touching)
+    for (int c = 0; c < count; c++)
+    {
+        if (slotOf[c] != -1)
+        {
+            continue;
+        }
+        for (int f = 0; f < 5; f++)
+        {
+            if (!fingerTaken[f] && !this->_fingers[f].is_touching)
+            {
+                fingerTaken[f] = true;
+                slotOf[c] = f;
+                break;
+            }
+        }
+        if (slotOf[c] == -1)
+        {
+            // every slot is held by an unmatched finger, reuse one
+            for (int f = 0; f < 5; f++)
+            {
+                if (!fingerTaken[f])
+                {
+                    fingerTaken[f] = true;
+                    slotOf[c] = f;
+                    break;
+                }
+            }
+            // the finger in that slot lifted: start the contact afresh, and
+            // have _buildEvents() report the lift and the touch separately
+            this->_updateFinger(slotOf[c], FingerState {});
+            this->_fingersReplaced |= 1 << slotOf[c];
+        }
+    }
+
+    for (int c = 0; c < count; c++)
+    {
+        this->_updateFinger(slotOf[c], contacts[c]);
+    }
+    // fingers without a contact have lifted
+    for (int f = 0; f < 5; f++)
+    {
+        if (!fingerTaken[f])
+        {
+            this->_updateFinger(f, FingerState {});
+        }
     }
 }
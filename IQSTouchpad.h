@@ -2,15 +2,61 @@
 #define IQS_TOUCHPAD_H
 
 #include "IQSRegisters.h"
-#include <vector>
 #include "Finger.h"
 #include "IQSQueue.h"
-#include <queue>
-#include <functional>
+#include "IQSEvents.h"
+#include "IQSFrame.h"
+#include "IQSBus.h"
+#include "I2CHelpers.h"
+#include "IQSTask.h"
+#include "IQSFilter.h"
+#include "IQSShadow.h"
+#include "IQSProfile.h"
+#include "IQSStats.h"
+#include "IQSCapture.h"
+#include "IQSDecode.h"
 #include <Arduino.h>
 
 #define DEFAULT_I2C_ADDRESS 0x74
 
+// number of recent frames whose finger count sizes the adaptive frame read
+#ifndef IQS_FINGER_HISTORY_LENGTH
+#define IQS_FINGER_HISTORY_LENGTH 8
+#endif
+
+// acquisition task settings, see beginAcquisitionTask()
+#ifndef IQS_ACQUISITION_CORE
+#define IQS_ACQUISITION_CORE 0
+#endif
+#ifndef IQS_ACQUISITION_PRIORITY
+#define IQS_ACQUISITION_PRIORITY 3
+#endif
+
+// reset sequence, see reset(): how long RST is held low, and how long to wait
+// for the first RDY window after releasing it before carrying on regardless
+#ifndef IQS_RESET_PULSE_US
+#define IQS_RESET_PULSE_US 1000
+#endif
+#ifndef IQS_BOOT_TIMEOUT_MS
+#define IQS_BOOT_TIMEOUT_MS 500
+#endif
+
+// settings the chip has accepted since construction, the ones written
+// again after a reset (see IQSTouchpad::_queueConfiguration)
+#define IQS_CONFIG_X_RESOLUTION (1 << 0)
+#define IQS_CONFIG_Y_RESOLUTION (1 << 1)
+#define IQS_CONFIG_XY_CONFIG_0 (1 << 2)
+#define IQS_CONFIG_MAX_FINGERS (1 << 3)
+#define IQS_CONFIG_REPORT_RATE (1 << 4)
+
+// system control 0 (0x0431): clears SHOW_RESET
+#define IQS_SYSTEM_CONTROL_ACK_RESET (1 << 7)
+
+// maximum number of touchpads that can be begun at once (1 to 8)
+#ifndef IQS_MAX_TOUCHPADS
+#define IQS_MAX_TOUCHPADS 4
+#endif
+
 enum TouchpadMode
 {
     ACTIVE,
@@ -20,8 +66,15 @@ enum TouchpadMode
     LP2,
 };
 
+class IQSBusScheduler;
+
 class IQSTouchpad
 {
+    // the scheduler starts windows on behalf of its touchpads
+    friend class IQSBusScheduler;
+    // a replay stands in for the RDY interrupt
+    friend class IQSReplay;
+
     private:
         byte _i2cAddress;
         int _PIN_RDY;
@@ -31,99 +84,471 @@ class IQSTouchpad
         // before it is initialized
         bool _initialized = false;
 
-        int _X_resolution;
-        int _Y_resolution;
+        // -1 until a resolution has been written
+        int _X_resolution = -1;
+        int _Y_resolution = -1;
 
         // queue for pending reads
-        std::queue<IQSRead> _readQueue;
+        IQSReadQueue _readQueue;
 
         // queue for pending writes
-        std::queue<IQSWrite> _writeQueue;
+        IQSWriteQueue _writeQueue;
+
+        // adaptive frame read length: finger counts of the last few frames
+        bool _adaptiveReadLength = false;
+        byte _fingerHistory[IQS_FINGER_HISTORY_LENGTH] = {};
+        int _fingerHistoryIndex = 0;
 
         // buffer for reading finger data in one large chunk
-        const int _bytes_to_read = 44;
-        byte* _finger_data_buffer = new byte[_bytes_to_read];
+        // 9 bytes for gestures and info, 7 bytes per finger
+        static const int _bytes_to_read = 44;
+        byte _finger_data_buffer[_bytes_to_read];
+        // bytes of it read this window (adaptive reads and continuations)
+        int _frameLength = 0;
 
         // flags
         // system flags
-        bool _RR_MISSED;
-        bool _SWITCH_STATE;
-        bool _SNAP_TOGGLE;
-        bool _TOO_MANY_FINGERS;
-        bool _PALM_DETECT;
-        bool _TP_MOVEMENT;
+        bool _RR_MISSED = false;
+        bool _SWITCH_STATE = false;
+        bool _SNAP_TOGGLE = false;
+        bool _TOO_MANY_FINGERS = false;
+        bool _PALM_DETECT = false;
+        bool _TP_MOVEMENT = false;
         // gesture flags
         // single finger gestures
-        bool _SWIPE_Y_NEG;
-        bool _SWIPE_Y_POS;
-        bool _SWIPE_X_NEG;
-        bool _SWIPE_X_POS;
-        bool _PRESS_AND_HOLD;
-        bool _TAP;
+        bool _SWIPE_Y_NEG = false;
+        bool _SWIPE_Y_POS = false;
+        bool _SWIPE_X_NEG = false;
+        bool _SWIPE_X_POS = false;
+        bool _PRESS_AND_HOLD = false;
+        bool _TAP = false;
         // multi finger gestures
-        bool _ZOOM;
-        bool _SCROLL;
-        bool _TWO_FINGER_TAP;
+        bool _ZOOM = false;
+        bool _SCROLL = false;
+        bool _TWO_FINGER_TAP = false;
+
+        // raw gesture bytes (single | multi << 8) and system info of the last frame
+        uint16_t _gestures = 0;
+        byte _systemInfo0 = 0;
+        byte _systemInfo1 = 0;
 
-        int _numFingers;
-        int _maxFingers;
+        int _numFingers = 0;
+        // chip default until setMaxFingers succeeds
+        int _maxFingers = 5;
+        // active mode report rate (ms), chip default until setReportRate succeeds
+        int _reportRate = 10;
 
         // finger data
         Finger _fingers[5] { Finger(0), Finger(1), Finger(2), Finger(3), Finger(4) };
         bool _wasUpdated = false;
 
-        // method for reading and updating finger data in bulk
-        void _readTouchData();
+        // method for decoding the frame in _finger_data_buffer
+        void _decodeTouchData();
+
+        // event stream: finger state and gestures of the previous frame, the
+        // events of the current one, and the onFrame subscribers
+        struct FingerState
+        {
+            bool is_touching;
+            int x;
+            int y;
+            int force;
+            int area;
+        };
+        FingerState _previousFingers[5] = {};
+        // slots whose Finger is not all zero, the others need no update
+        // while their slot stays empty
+        byte _fingersInUse = 0;
+        // slots handed from a lifted finger to a new contact in this frame
+        byte _fingersReplaced = 0;
+
+        // finger tracking: keep each contact in the same slot across frames
+        bool _fingerTracking = false;
+        int _trackingMaxDistance = 0;
+        void _trackFingers(const FingerState* contacts, int count);
+
+        // coordinate filter between the decode and the fingers
+        IQSFilterConfig _filterConfig;
+        IQSAxisFilter _filterX[5];
+        IQSAxisFilter _filterY[5];
+        uint32_t _filterDtMicros = 0;
+        uint32_t _previousFrameMicros = 0;
+
+        // method for handing a decoded contact to a finger slot (through the filter)
+        void _updateFinger(int slot, const FingerState& contact);
+
+        uint16_t _previousGestures = 0;
+        IQSTouchEvent _events[IQS_MAX_FRAME_EVENTS];
+        int _numEvents = 0;
+        IQSFrameCallback _frameSubscribers[IQS_MAX_FRAME_SUBSCRIBERS];
+
+        // method for turning the last decoded frame into events
+        void _buildEvents();
+        // method for handing the events to the subscribers
+        void _dispatchEvents();
+
+        // frame ring: decoded frames kept until the application drains them
+        bool _frameBuffering = false;
+        IQSFrameRing _frames;
+        uint32_t _frameSequence = 0;
+        IQSFrame _lastFrame = {};
+        uint32_t _framesDropped = 0;
+
+        // method for appending the last decoded frame to the ring
+        void _pushFrame();
+
+        // largest gap (in bytes) bridged when merging pending reads into one burst
+        int _readGapTolerance = 4;
+
+        // communication window state machine
+        //
+        // update() walks a window through its steps (frame read, queued
+        // reads, queued writes, end of window), handing one transaction at a
+        // time to the bus backend and moving on as each one completes, so on
+        // a non-blocking backend it never waits for the bus
+        enum WindowState
+        {
+            WINDOW_IDLE,
+            WINDOW_FRAME,
+            WINDOW_READS,
+            WINDOW_SHADOW,
+            WINDOW_WRITES,
+            WINDOW_PROFILE,
+            WINDOW_END,
+        };
+        WindowState _windowState = WINDOW_IDLE;
+        IQSBusBackend* _bus = &IQSWire;
+        IQSTransaction _transaction = {};
+        // the transaction has been set up but the (shared) bus was busy
+        bool _transactionWaiting = false;
+        byte _txBuffer[IQS_I2C_BUFFER_LENGTH];
+        byte _rxBuffer[IQS_I2C_BUFFER_LENGTH];
+
+        // frame read progress
+        int _frameSlots = 0;
+        bool _frameContinued = false;
+
+        // requests drained from the queues for this window, in queue order,
+        // with their planned order (sorted by address) and results
+        IQSRead _reads[IQS_READ_QUEUE_DEPTH];
+        int _readValues[IQS_READ_QUEUE_DEPTH];
+        byte _readErrors[IQS_READ_QUEUE_DEPTH];
+        int _readOrder[IQS_READ_QUEUE_DEPTH];
+        int _numReads = 0;
+        // reads from the queue, the rest are the driver's own (instrumentation)
+        // and stay out of the capture
+        int _numQueuedReads = 0;
+        int _numReadsOrdered = 0;
+        IQSWrite _writes[IQS_WRITE_QUEUE_DEPTH];
+        byte _writeErrors[IQS_WRITE_QUEUE_DEPTH];
+        int _writeOrder[IQS_WRITE_QUEUE_DEPTH];
+        int _numWrites = 0;
+        int _numWritesOrdered = 0;
+        // the burst in flight covers _readOrder/_writeOrder[_burstFirst, _burstLast)
+        int _burstFirst = 0;
+        int _burstLast = 0;
+        int _burstStart = 0;
+
+        void _startTransaction(byte i2cAddress, const byte* tx, int txLength, byte* rx, int rxLength);
+        bool _transactionDone();
+        void _runWindow();
+        void _completeTransaction();
+        void _startFrameRead();
+        void _completeFrameRead();
+        // methods for applying all pending reads as merged burst reads
+        void _planReads();
+        void _startReadBurst();
+        void _completeReadBurst();
+        // methods for applying all pending writes as merged block writes
+        void _planWrites();
+        // methods for reading wanted registers into the shadow before the writes
+        void _startShadowFill();
+        void _completeShadowFill();
+        // method for resolving modifies and dropping no-op writes against the shadow
+        void _resolveWrites();
+        void _startWriteBurst();
+        void _completeWriteBurst();
+        // methods for writing, then reading back, the pending profile
+        void _startProfileBurst();
+        void _completeProfileBurst();
+        void _finishProfile(byte error);
+        void _startEndWindow();
+        void _completeWindow();
+        // drops the window in flight, aborting its transaction on the bus
+        void _abortWindow();
+
+        // settings registers as the chip holds them, see IQSShadow.h
+        IQSShadowRegisters _shadow;
+        volatile bool _shadowLoadRequested = false;
+        int _shadowFillAddress = 0;
+        int _shadowFillLength = 0;
+        byte _shadowFillError = 0;
+        uint32_t _writesSuppressed = 0;
+
+        // configuration profile being loaded, see loadProfile()
+        const byte* _profile = nullptr;
+        int _profileLength = 0;
+        IQSProfileCallback _profileCallback;
+        volatile bool _profilePending = false;
+        bool _profileVerifying = false;
+        IQSProfileCursor _profileCursor = {};
+        int _profileBurstLength = 0;
+        int _profileWindowBytes = 0;
+        // most profile bytes per window (0 = no limit), at Wire's default
+        // clock until begin() sets another
+        int _profileWindowLimit = IQSProfile::windowBytes(100000);
+
+        // the chip has been reset and has not opened its first window yet
+        bool _booting = false;
+        uint32_t _resetMicros = 0;
+        uint32_t _bootTimeouts = 0;
+        // XY config 0 as last written, re-applied after a reset
+        byte _xyConfig0 = 0;
+        // IQS_CONFIG_* bits of the settings written successfully
+        byte _configApplied = 0;
+        // SHOW_RESET handling: a reset from reset() is expected and already
+        // re-configured; any other the chip did on its own
+        bool _resetExpected = false;
+        bool _chipResetHandled = false;
+        bool _resetAckPending = false;
+        uint32_t _chipResets = 0;
+
+        // method for following the boot after a reset, true while the chip is not up
+        bool _updateReset();
+        // method for queueing the settings the chip loses in a reset
+        void _queueConfiguration();
+        // method for reacting to SHOW_RESET in a frame
+        void _onShowReset(bool showReset);
+
+#if IQS_INSTRUMENTATION
+        // window counters, and the totals of the window in progress
+        IQSWindowStats _stats;
+        uint32_t _windowTransactions = 0;
+        uint32_t _windowBytes = 0;
+        uint32_t _windowCallbackMicros = 0;
+        IQSLatencyStats _latency;
+        uint32_t _windowOpenMicros = 0;
+#endif
+        IQSCaptureWriter* _capture = nullptr;
 
         // method for setting the default read address. should not be called by user
-        void _setDefaultReadAddress(IQSRegister* reg);
+        void _setDefaultReadAddress(const IQSRegister* reg);
 
         // base begin method
         void _begin();
 
+        // RDY interrupt registry and handlers, see IQSTouchpad.cpp
+        static IQSTouchpad* volatile _touchpads[IQS_MAX_TOUCHPADS];
+        static void _readyISR(void* touchpad);
+        template <int SLOT>
+        static void _readyTrampoline();
+        static void (*_trampoline(int slot))();
+        bool _attachReadyInterrupt();
+
+        // set from the RDY interrupt, with the time of the edge. an edge that
+        // arrives while the previous window is still pending means the
+        // application was too slow to service it
+        volatile bool _ready = false;
+        volatile uint32_t _readyMicros = 0;
+        volatile uint32_t _windowsMissed = 0;
+        static void _onReady(IQSTouchpad* touchpad);
+
+        // acquisition task, woken by the RDY interrupt
+        IQSTask _task;
+        static void _acquisitionMain(void* touchpad);
+
     public:
         IQSTouchpad(int PIN_RDY, int PIN_RST, int X_resolution = -1, int Y_resolution = -1, bool switch_xy_axis = false, bool flip_y = false, bool flip_x = false, int maxFingers = 5, byte i2cAddress = DEFAULT_I2C_ADDRESS);
 
-        // public only because the interrupt handler needs to access it
-        static std::vector<IQSTouchpad*> _touchpads;
-        volatile bool _ready = false;
+        ~IQSTouchpad();
+
         const volatile bool& ready = _ready;
+        // micros() at the rising edge of RDY that opened the pending window
+        const volatile uint32_t& readyMicros = _readyMicros;
 
         // public
         void begin();
         void begin(uint32_t freq_hz);
+        // reset the chip without waiting for it to boot: RST is pulsed low
+        // for IQS_RESET_PULSE_US, and update() carries on once the chip opens
+        // its first window (or after IQS_BOOT_TIMEOUT_MS). the resolution, XY config, max fingers and active
+        // report rate (those that were written successfully before) and the
+        // default read address are written again in that first window; anything else (e.g. a profile) has to be re-applied.
+        // several touchpads reset in parallel
         void reset();
+        bool resetInProgress();
         void endCommunicationWindow();
+        // services the current communication window. with the default Wire
+        // backend the whole window runs inside one call; with a non-blocking
+        // backend each call starts or finishes at most a few transactions and
+        // returns straight away, so call it often while windowInProgress()
         void update();
+        // bus backend for the communication windows (nullptr restores Wire),
+        // see IQSBus.h. may only be changed between windows
+        void setBusBackend(IQSBusBackend* backend);
+        bool windowInProgress();
+        // record every frame block and queued read/write result into a
+        // capture (nullptr stops), see IQSCapture.h
+        void setCapture(IQSCaptureWriter* capture);
         void setResolution(int x_resolution, int y_resolution);
         void setReportRate(int report_rate_milliseconds, TouchpadMode mode);
         void setXYConfig0(byte value);
         void setXYConfig0(bool PALM_REJECT, bool SWITCH_XY_AXIS, bool FLIP_Y, bool FLIP_X);
         void setMaxFingers(int max_fingers);
+        // read only as many finger slots per frame as recent frames needed,
+        // fetching any extra fingers with a continuation read
+        void setAdaptiveReadLength(bool enabled);
+        // pending reads separated by at most this many bytes share one burst read
+        void setReadGapTolerance(int bytes);
         Finger getFinger(int finger_number);
+        // keep each contact in the same finger slot for as long as it
+        // touches, matching contacts to the previous frame's fingers by
+        // distance, so a finger's id and relative_x/relative_y follow the
+        // contact rather than the chip's slot order. contacts further than
+        // maxDistance from any finger start a new one (0 = no limit).
+        // while enabled, touching fingers need not be in the first
+        // numFingers slots, so check is_touching on all 5
+        void setFingerTracking(bool enabled, int maxDistance = 0);
+        // smooth and/or extrapolate finger coordinates (see IQSFilter.h).
+        // the filters restart whenever a finger lands, and are reset by
+        // every call. filtered coordinates stay within the resolution
+        void setFilter(const IQSFilterConfig& config);
+
+        // event stream
+        // subscribe to frames that changed something, returns a handle for
+        // removeOnFrame, or -1 if IQS_MAX_FRAME_SUBSCRIBERS is reached
+        int onFrame(IQSFrameCallback callback);
+        void removeOnFrame(int handle);
+        // events of the last frame (empty if nothing changed)
+        const IQSTouchEvent* getEvents(int& count);
+
+        // acquisition task
+        // runs the whole acquisition loop (wait for RDY, read the frame,
+        // serve the queues, end the window) in a dedicated task woken
+        // straight from the RDY interrupt, pinned to core on ESP32. frames
+        // reach the application through the frame ring, which this enables;
+        // drain it with readFrame()/drainFrames() and do not call update()
+        // while the task runs. onFrame subscribers and queue callbacks run
+        // in the task. returns false where tasks are not available
+        bool beginAcquisitionTask(int core = IQS_ACQUISITION_CORE, int priority = IQS_ACQUISITION_PRIORITY);
+        void endAcquisitionTask();
+
+        // frame ring
+        // when enabled, every decoded frame is also kept in a ring of
+        // IQS_FRAME_RING_DEPTH frames, so a slow loop() can catch up on
+        // several frames (and one-shot gestures) at once. when the ring is
+        // full the newest frame is dropped and counted in framesDropped
+        void setFrameBuffering(bool enabled);
+        int framesAvailable();
+        // copy the oldest frame without removing it
+        bool peekFrame(IQSFrame& frame);
+        // remove the oldest frame
+        bool readFrame(IQSFrame& frame);
+        // remove up to maxFrames of the oldest frames, returns how many
+        int drainFrames(IQSFrame* frames, int maxFrames);
 
         // queue management
-        void queueRead(IQSRead read);
+        // all of these return false (and call the callback with error code
+        // 10) if the queue is full, see IQS_READ_QUEUE_DEPTH/IQS_WRITE_QUEUE_DEPTH
+        //
+        // callbacks can be any lambda, functor or function pointer whose
+        // captures fit in IQS_CALLBACK_STORAGE bytes (see IQSCallback.h)
+        //
+        // these may be called from any number of tasks at once (the queues
+        // are lock-free, see IQSRing.h) while update() runs elsewhere.
+        // callbacks run in whichever task calls update()
+        bool queueRead(IQSRead read);
         // register + callback(int readValue, byte errorCode)
-        void queueRead(IQSRegister* reg, std::function<void(int, byte)> callback);
+        template <typename Callback>
+        bool queueRead(const IQSRegister* reg, Callback callback);
         // register + #bytes + callback(int registerAddress, int readValue, byte errorCode)
-        void queueRead(int registerAddress, int numBytes, int dataType, std::function<void(int, int, byte)> callback);
+        template <typename Callback>
+        bool queueRead(int registerAddress, int numBytes, int dataType, Callback callback);
         // register + #bytes + callback(int registerAddress, int readValue, byte errorCode), int dataType [see IQSRegisters.h]
-        void queueRead(int registerAddress, int numBytes, std::function<void(int, int, byte)> callback, int dataType = 1);
-        void queueWrite(IQSWrite write);
-        void queueWrite(IQSRegister* reg, int value);
-        void queueWrite(IQSRegister* reg, int value, std::function<void(int, byte)> callback);
-        void queueWrite(int registerAddress, int numBytes, int value);
+        template <typename Callback>
+        bool queueRead(int registerAddress, int numBytes, Callback callback, int dataType = 1);
+        bool queueWrite(IQSWrite write);
+        bool queueWrite(const IQSRegister* reg, int value);
+        // register + valueToWrite + callback(int registerAddress, byte errorCode)
+        template <typename Callback>
+        bool queueWrite(const IQSRegister* reg, int value, Callback callback);
+        bool queueWrite(int registerAddress, int numBytes, int value);
         // register + #bytes + valueToWrite + callback(int registerAddress, byte errorCode)
-        void queueWrite(int registerAddress, int numBytes, int value, std::function<void(int, byte)> callback);
+        template <typename Callback>
+        bool queueWrite(int registerAddress, int numBytes, int value, Callback callback);
+        // write only the bits of value selected by mask, keeping the other
+        // bits as the chip holds them. the rest of the register comes from the
+        // shadow (read in the same window if needed), and modifies of the same
+        // register queued before the next window are applied in order.
+        // only for registers in the shadow (IQS_SHADOW_FIRST to
+        // IQS_SHADOW_LAST), others fail with error code 7. if the register
+        // cannot be read the modify fails with IQS_ERROR_NOT_SHADOWED
+        bool queueModify(const IQSRegister* reg, int mask, int value);
+        // register + mask + value + callback(int registerAddress, byte errorCode)
+        template <typename Callback>
+        bool queueModify(const IQSRegister* reg, int mask, int value, Callback callback);
+
+        // configuration profile
+        // write a profile (see IQSProfile.h) in as few block writes as
+        // possible, starting with the next window (the very first one if
+        // called before begin()) and spread over as many windows as the bus
+        // clock needs, then read every byte back. the image must
+        // stay valid until the callback runs. returns false (and calls the
+        // callback) with error code 9 if the image is malformed, or 7 if
+        // another profile is still loading
+        bool loadProfile(const byte* image, int length, IQSProfileCallback callback = nullptr);
+        bool profileLoading();
+
+        // instrumentation (IQS_INSTRUMENTATION, see IQSStats.h)
+        // a copy of the counters, taken between windows if update() runs in
+        // another task. empty when compiled out
+        IQSWindowStats windowStats();
+        void resetWindowStats();
+        // latency histograms from the RDY edge to the application. call
+        // acknowledgeFrame() when a frame has been consumed (e.g. its HID
+        // report sent), with the frame from readFrame()/drainFrames(), or
+        // without one for the last decoded frame
+        void acknowledgeFrame(const IQSFrame& frame);
+        void acknowledgeFrame();
+        const IQSLatencyStats& latencyStats();
+        void resetLatencyStats();
+        // print the histograms, e.g. printLatency(Serial)
+        void printLatency(Print& out);
+
+        // shadow registers
+        // read the whole shadowed range in the next window(s), so that any
+        // write of a value the chip already holds is skipped from then on.
+        // without it, a register is only shadowed once it has been read or
+        // written. reset() clears the shadow
+        void loadShadowRegisters();
+        // value of a register as last read from or written to the chip,
+        // false if the shadow does not hold it
+        bool getShadowRegister(const IQSRegister* reg, int& value);
 
         // getters
         const bool& wasUpdated = _wasUpdated;
+        // number of events produced by the last update()
+        const int& numEvents = _numEvents;
         const int& numFingers = _numFingers;
+        const int& reportRate = _reportRate;
+        // the last decoded frame, whether or not frame buffering is on
+        const IQSFrame& lastFrame = _lastFrame;
+        // resets where the chip did not open a window within IQS_BOOT_TIMEOUT_MS
+        const uint32_t& bootTimeouts = _bootTimeouts;
+        // resets the chip reported (SHOW_RESET) without reset() being called,
+        // e.g. a watchdog or brown-out. the shadow registers are dropped and
+        // the settings written again, as after reset()
+        const uint32_t& chipResets = _chipResets;
+        // writes skipped because the chip already held the value
+        const uint32_t& writesSuppressed = _writesSuppressed;
+        // frames lost because the frame ring was full
+        const uint32_t& framesDropped = _framesDropped;
+        // windows that opened while the previous one was still waiting for update()
+        const volatile uint32_t& windowsMissed = _windowsMissed;
 
         const int& X_resolution = _X_resolution;
         const int& Y_resolution = _Y_resolution;
-        const int& I2CAddress = _i2cAddress;
+        const byte& I2CAddress = _i2cAddress;
         const int& PIN_RDY = _PIN_RDY;
         const int& PIN_RST = _PIN_RST;
         const bool& RR_MISSED = _RR_MISSED;
@@ -143,4 +568,122 @@ class IQSTouchpad
         const bool& TWO_FINGER_TAP = _TWO_FINGER_TAP;
 };
 
+// the callback adapters are templates so that the user's callable is stored
+// directly inside the queued request's IQSCallback, instead of being wrapped
+// in a second type-erased object
+
+template <typename Callback>
+bool IQSTouchpad::queueRead(const IQSRegister* reg, Callback callback)
+{
+    // define a lambda function that will take the i2cAddress, registerAddress, read value, and return code and pass only the read value and return code to the callback function
+    auto callbackWrapper = [callback](int, int registerAddress, int readValue, byte returnCode)
+    {
+        callback(readValue, returnCode);
+    };
+
+    // create a read object and add it to the queue
+    IQSRead newRead = {
+        this->_i2cAddress,
+        reg->getInfo(),
+        callbackWrapper
+    };
+
+    return this->queueRead(newRead);
+}
+
+template <typename Callback>
+bool IQSTouchpad::queueRead(int registerAddress, int numBytes, Callback callback, int dataType)
+{
+    return this->queueRead(registerAddress, numBytes, dataType, callback);
+}
+
+template <typename Callback>
+bool IQSTouchpad::queueRead(int registerAddress, int numBytes, int dataType, Callback callback)
+{
+    // define a lambda function that will take the i2cAddress, registerAddress, read value, and return code and pass only the register address, read value and return code to the callback function
+    auto callbackWrapper = [callback](int, int registerAddress, int readValue, byte returnCode)
+    {
+        callback(registerAddress, readValue, returnCode);
+    };
+
+    // create a read object and add it to the queue
+    IQSRead newRead = {
+        this->_i2cAddress,
+        IQSRegisterInfo { registerAddress, (byte)numBytes, 'b', (byte)dataType },
+        callbackWrapper
+    };
+
+    return this->queueRead(newRead);
+}
+
+template <typename Callback>
+bool IQSTouchpad::queueWrite(const IQSRegister* reg, int value, Callback callback)
+{
+    // create a wrapper callback function
+    auto callbackWrapper = [callback](int, int registerAddress, byte returnCode)
+    {
+        callback(registerAddress, returnCode);
+    };
+
+    // create a write object and add it to the queue
+    IQSWrite newWrite = {
+        this->_i2cAddress,
+        reg->getInfo(),
+        value,
+        callbackWrapper,
+        // write every bit
+        0
+    };
+
+    return this->queueWrite(newWrite);
+}
+
+template <typename Callback>
+bool IQSTouchpad::queueWrite(int registerAddress, int numBytes, int value, Callback callback)
+{
+    // create a wrapper callback function
+    auto callbackWrapper = [callback](int, int registerAddress, byte returnCode)
+    {
+        callback(registerAddress, returnCode);
+    };
+
+    // create a write object and add it to the queue
+    IQSWrite newWrite = {
+        this->_i2cAddress,
+        IQSRegisterInfo { registerAddress, (byte)numBytes, 'b', 0 },
+        value,
+        callbackWrapper,
+        // write every bit
+        0
+    };
+
+    return this->queueWrite(newWrite);
+}
+
+template <typename Callback>
+bool IQSTouchpad::queueModify(const IQSRegister* reg, int mask, int value, Callback callback)
+{
+    auto callbackWrapper = [callback](int, int registerAddress, byte returnCode)
+    {
+        callback(registerAddress, returnCode);
+    };
+
+    if (mask == 0)
+    {
+        // nothing to change
+        callback(reg->getAddress(), 0);
+        return true;
+    }
+
+    IQSWrite newWrite = {
+        this->_i2cAddress,
+        reg->getInfo(),
+        value,
+        callbackWrapper,
+        mask
+    };
+
+    return this->queueWrite(newWrite);
+}
+
 #endif // IQS_TOUCHPAD_H
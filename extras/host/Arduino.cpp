@@ -0,0 +1,258 @@
+#include "Arduino.h"
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <stdio.h>
+
+#define HOST_NUM_PINS 256
+
+namespace
+{
+    struct PinState
+    {
+        int mode = INPUT;
+        int value = LOW;
+        void (*isr)() = nullptr;
+        int isrMode = 0;
+    };
+
+    // the clock and the pins can be touched from more than one thread
+    // (acquisition tasks, stress tests), and an ISR can re-enter the shim,
+    // so everything is guarded by one recursive lock
+    std::recursive_mutex hostLock;
+    uint64_t clockMicros = 0;
+    PinState pins[HOST_NUM_PINS];
+    std::vector<HostArduino::Peripheral*> peripherals;
+
+    bool validPin(int pin)
+    {
+        return pin >= 0 && pin < HOST_NUM_PINS;
+    }
+
+    void setPin(int pin, int value)
+    {
+        PinState& state = pins[pin];
+        int previous = state.value;
+        state.value = value ? HIGH : LOW;
+
+        if (state.isr == nullptr || previous == state.value)
+        {
+            return;
+        }
+
+        bool rising = state.value == HIGH;
+        if ((state.isrMode == CHANGE) ||
+            (state.isrMode == RISING && rising) ||
+            (state.isrMode == FALLING && !rising))
+        {
+            state.isr();
+        }
+    }
+}
+
+unsigned long millis()
+{
+    return (unsigned long)(HostArduino::nowMicros() / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)HostArduino::nowMicros();
+}
+
+void delay(unsigned long ms)
+{
+    HostArduino::advanceMicros((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    HostArduino::advanceMicros(us);
+}
+
+void pinMode(int pin, int mode)
+{
+    std::lock_guard<std::recursive_mutex> lock(hostLock);
+    if (!validPin(pin)) { return; }
+    pins[pin].mode = mode;
+    if (mode == INPUT_PULLUP)
+    {
+        pins[pin].value = HIGH;
+    }
+}
+
+int digitalRead(int pin)
+{
+    std::lock_guard<std::recursive_mutex> lock(hostLock);
+    if (!validPin(pin)) { return LOW; }
+    return pins[pin].value;
+}
+
+void digitalWrite(int pin, int value)
+{
+    std::lock_guard<std::recursive_mutex> lock(hostLock);
+    if (!validPin(pin)) { return; }
+    pins[pin].value = value ? HIGH : LOW;
+    for (size_t i = 0; i < peripherals.size(); i++)
+    {
+        peripherals[i]->onPinWritten(pin, pins[pin].value);
+    }
+}
+
+int digitalPinToInterrupt(int pin)
+{
+    return pin;
+}
+
+void attachInterrupt(int interrupt, void (*isr)(), int mode)
+{
+    std::lock_guard<std::recursive_mutex> lock(hostLock);
+    if (!validPin(interrupt)) { return; }
+    pins[interrupt].isr = isr;
+    pins[interrupt].isrMode = mode;
+}
+
+void detachInterrupt(int interrupt)
+{
+    std::lock_guard<std::recursive_mutex> lock(hostLock);
+    if (!validPin(interrupt)) { return; }
+    pins[interrupt].isr = nullptr;
+    pins[interrupt].isrMode = 0;
+}
+
+namespace HostArduino
+{
+    void lock()
+    {
+        hostLock.lock();
+    }
+
+    void unlock()
+    {
+        hostLock.unlock();
+    }
+
+    void addPeripheral(Peripheral* peripheral)
+    {
+        std::lock_guard<std::recursive_mutex> lock(hostLock);
+        peripherals.push_back(peripheral);
+    }
+
+    void removePeripheral(Peripheral* peripheral)
+    {
+        std::lock_guard<std::recursive_mutex> lock(hostLock);
+        peripherals.erase(std::remove(peripherals.begin(), peripherals.end(), peripheral), peripherals.end());
+    }
+
+    uint64_t nowMicros()
+    {
+        std::lock_guard<std::recursive_mutex> lock(hostLock);
+        return clockMicros;
+    }
+
+    void advanceMicros(uint64_t us)
+    {
+        std::lock_guard<std::recursive_mutex> lock(hostLock);
+        uint64_t target = clockMicros + us;
+
+        // step through every peripheral event on the way so that ISRs
+        // observe the time at which their edge actually happened
+        while (true)
+        {
+            uint64_t next = UINT64_MAX;
+            for (size_t i = 0; i < peripherals.size(); i++)
+            {
+                next = std::min(next, peripherals[i]->nextEventMicros());
+            }
+            if (next > target)
+            {
+                break;
+            }
+            clockMicros = std::max(clockMicros, next);
+            for (size_t i = 0; i < peripherals.size(); i++)
+            {
+                peripherals[i]->onTimeAdvanced(clockMicros);
+            }
+        }
+
+        clockMicros = target;
+        for (size_t i = 0; i < peripherals.size(); i++)
+        {
+            peripherals[i]->onTimeAdvanced(clockMicros);
+        }
+    }
+
+    void drivePin(int pin, int value)
+    {
+        std::lock_guard<std::recursive_mutex> lock(hostLock);
+        if (!validPin(pin)) { return; }
+        setPin(pin, value);
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::recursive_mutex> lock(hostLock);
+        clockMicros = 0;
+        for (int i = 0; i < HOST_NUM_PINS; i++)
+        {
+            pins[i] = PinState();
+        }
+        peripherals.clear();
+    }
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+    size_t written = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        written += this->write(buffer[i]);
+    }
+    return written;
+}
+
+size_t Print::print(const char* text)
+{
+    return this->write((const uint8_t*)text, strlen(text));
+}
+
+size_t Print::print(char c)
+{
+    return this->write((uint8_t)c);
+}
+
+size_t Print::print(int value)
+{
+    return this->print((long)value);
+}
+
+size_t Print::print(unsigned int value)
+{
+    return this->print((unsigned long)value);
+}
+
+size_t Print::print(long value)
+{
+    char text[24];
+    snprintf(text, sizeof(text), "%ld", value);
+    return this->print(text);
+}
+
+size_t Print::print(unsigned long value)
+{
+    char text[24];
+    snprintf(text, sizeof(text), "%lu", value);
+    return this->print(text);
+}
+
+size_t Print::println()
+{
+    return this->print("\r\n");
+}
+
+size_t HostSerial::write(uint8_t c)
+{
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+HostSerial Serial;
@@ -0,0 +1,112 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// minimal stand-in for the Arduino core, used to build and run the driver
+// on a desktop machine (see extras/host/README.md)
+//
+// time is virtual: micros()/millis() only move forward when delay() is
+// called, when the emulated I2C bus transfers bytes, or when the host
+// program calls HostArduino::advanceMicros(). this keeps runs
+// deterministic and lets bus time be measured independently of CPU time
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define IQS_HOST 1
+
+typedef uint8_t byte;
+
+#define LOW 0
+#define HIGH 1
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define IRAM_ATTR
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(int pin, int mode);
+int digitalRead(int pin);
+void digitalWrite(int pin, int value);
+
+int digitalPinToInterrupt(int pin);
+void attachInterrupt(int interrupt, void (*isr)(), int mode);
+void detachInterrupt(int interrupt);
+
+// text output, as far as the library uses it
+class Print
+{
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t c) = 0;
+        virtual size_t write(const uint8_t* buffer, size_t size);
+
+        size_t print(const char* text);
+        size_t print(char c);
+        size_t print(int value);
+        size_t print(unsigned int value);
+        size_t print(long value);
+        size_t print(unsigned long value);
+        size_t println();
+        template <typename T>
+        size_t println(T value) { return print(value) + println(); }
+};
+
+// Serial writes to stdout
+class HostSerial : public Print
+{
+    public:
+        void begin(unsigned long) {}
+        size_t write(uint8_t c) override;
+        using Print::write;
+};
+extern HostSerial Serial;
+
+namespace HostArduino
+{
+    // anything that needs to react to the passage of virtual time or to
+    // the MCU driving one of its pins (e.g. an emulated chip's RST input)
+    class Peripheral
+    {
+        public:
+            virtual ~Peripheral() {}
+            virtual void onTimeAdvanced(uint64_t) {}
+            virtual void onPinWritten(int, int) {}
+            // time of the next scheduled internal event, so the clock can
+            // stop there on its way forward (UINT64_MAX if none)
+            virtual uint64_t nextEventMicros() { return UINT64_MAX; }
+    };
+
+    void addPeripheral(Peripheral* peripheral);
+    void removePeripheral(Peripheral* peripheral);
+
+    // full 64 bit virtual clock
+    uint64_t nowMicros();
+
+    // move the virtual clock forward, letting every peripheral catch up
+    void advanceMicros(uint64_t us);
+
+    // drive an MCU input pin from outside, firing any attached interrupt
+    // whose mode matches the edge
+    void drivePin(int pin, int value);
+
+    // reset the clock, pins, interrupts and peripherals to power-on state
+    void reset();
+
+    // the lock guarding the clock, pins and peripherals, for shims whose
+    // calls reach a peripheral from another thread (see Wire.cpp)
+    void lock();
+    void unlock();
+}
+
+#endif // HOST_ARDUINO_H
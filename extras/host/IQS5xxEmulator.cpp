@@ -0,0 +1,368 @@
+#include "IQS5xxEmulator.h"
+
+// register addresses used by the model (see IQSRegisters.h)
+#define EMU_REG_PRODUCT_NUMBER 0x0000
+#define EMU_REG_PROJECT_NUMBER 0x0002
+#define EMU_REG_MAJOR_VERSION 0x0004
+#define EMU_REG_MINOR_VERSION 0x0005
+#define EMU_REG_PREVIOUS_CYCLE_TIME 0x000C
+#define EMU_REG_SINGLE_FINGER_GESTURES 0x000D
+#define EMU_REG_MULTI_FINGER_GESTURES 0x000E
+#define EMU_REG_SYSTEM_INFO_0 0x000F
+#define EMU_REG_SYSTEM_INFO_1 0x0010
+#define EMU_REG_NUM_FINGERS 0x0011
+#define EMU_REG_RELATIVE_X 0x0012
+#define EMU_REG_RELATIVE_Y 0x0014
+#define EMU_REG_FINGER_DATA 0x0016
+#define EMU_REG_ACTIVE_REPORT_RATE 0x057A
+#define EMU_REG_IDLE_TOUCH_REPORT_RATE 0x057C
+#define EMU_REG_IDLE_REPORT_RATE 0x057E
+#define EMU_REG_LP1_REPORT_RATE 0x0580
+#define EMU_REG_LP2_REPORT_RATE 0x0582
+#define EMU_REG_I2C_TIMEOUT 0x058A
+#define EMU_REG_SYSTEM_CONTROL_0 0x0431
+#define EMU_REG_XY_CONFIG_0 0x0669
+#define EMU_REG_MAX_MULTI_TOUCHES 0x066A
+#define EMU_REG_X_RESOLUTION 0x066E
+#define EMU_REG_Y_RESOLUTION 0x0670
+#define EMU_REG_DEFAULT_READ_ADDRESS 0x0675
+#define EMU_REG_SINGLE_FINGER_GESTURES_SETTINGS 0x06B7
+#define EMU_REG_MULTI_FINGER_GESTURES_SETTINGS 0x06B8
+#define EMU_REG_END_COMMUNICATION 0xEEEE
+
+#define EMU_FINGER_DATA_SIZE 7
+
+#define EMU_SHOW_RESET (1 << 7)
+#define EMU_ACK_RESET (1 << 7)
+
+// shortest time between closing one window and opening the next, standing
+// in for the chip's own sensing and processing
+#define EMU_MIN_PROCESSING_MICROS 500
+
+IQS5xxEmulator::IQS5xxEmulator(int PIN_RDY, int PIN_RST, uint8_t i2cAddress)
+{
+    this->_PIN_RDY = PIN_RDY;
+    this->_PIN_RST = PIN_RST;
+    this->_i2cAddress = i2cAddress;
+    this->_memory.assign(0x10000, 0);
+    this->_loadDefaults();
+
+    // powered up with RST released: boot straight away
+    uint64_t now = HostArduino::nowMicros();
+    this->_bootAt = now + this->_bootMicros;
+
+    Wire.attach(this);
+    HostArduino::addPeripheral(this);
+}
+
+IQS5xxEmulator::~IQS5xxEmulator()
+{
+    Wire.detach(this);
+    HostArduino::removePeripheral(this);
+}
+
+void IQS5xxEmulator::_loadDefaults()
+{
+    this->_memory.assign(0x10000, 0);
+    this->_showReset = true;
+
+    // IQS550, B000 firmware
+    this->pokeWord(EMU_REG_PRODUCT_NUMBER, 40);
+    this->pokeWord(EMU_REG_PROJECT_NUMBER, 15);
+    this->poke(EMU_REG_MAJOR_VERSION, 2);
+    this->poke(EMU_REG_MINOR_VERSION, 0);
+
+    this->pokeWord(EMU_REG_ACTIVE_REPORT_RATE, 10);
+    this->pokeWord(EMU_REG_IDLE_TOUCH_REPORT_RATE, 50);
+    this->pokeWord(EMU_REG_IDLE_REPORT_RATE, 100);
+    this->pokeWord(EMU_REG_LP1_REPORT_RATE, 160);
+    this->pokeWord(EMU_REG_LP2_REPORT_RATE, 160);
+    this->poke(EMU_REG_I2C_TIMEOUT, 10);
+
+    this->poke(EMU_REG_XY_CONFIG_0, 0);
+    this->poke(EMU_REG_MAX_MULTI_TOUCHES, IQS5XX_EMULATOR_NUM_FINGERS);
+    this->pokeWord(EMU_REG_X_RESOLUTION, 3072);
+    this->pokeWord(EMU_REG_Y_RESOLUTION, 2048);
+    this->pokeWord(EMU_REG_DEFAULT_READ_ADDRESS, EMU_REG_SINGLE_FINGER_GESTURES);
+
+    this->poke(EMU_REG_SINGLE_FINGER_GESTURES_SETTINGS, 0x3F);
+    this->poke(EMU_REG_MULTI_FINGER_GESTURES_SETTINGS, 0x07);
+}
+
+uint8_t IQS5xxEmulator::peek(uint16_t address)
+{
+    return this->_memory[address];
+}
+
+uint16_t IQS5xxEmulator::peekWord(uint16_t address)
+{
+    return (uint16_t)((this->_memory[address] << 8) | this->_memory[(uint16_t)(address + 1)]);
+}
+
+void IQS5xxEmulator::poke(uint16_t address, uint8_t value)
+{
+    this->_memory[address] = value;
+}
+
+void IQS5xxEmulator::pokeWord(uint16_t address, uint16_t value)
+{
+    this->_memory[address] = (value >> 8) & 0xFF;
+    this->_memory[(uint16_t)(address + 1)] = value & 0xFF;
+}
+
+void IQS5xxEmulator::setTouches(const IQS5xxEmulatorTouch* touches, int numTouches)
+{
+    this->_numTouches = numTouches < 0 ? 0 : numTouches;
+    for (int i = 0; i < IQS5XX_EMULATOR_NUM_FINGERS; i++)
+    {
+        this->_touches[i] = i < this->_numTouches ? touches[i] : IQS5xxEmulatorTouch();
+    }
+}
+
+void IQS5xxEmulator::setGestures(uint8_t singleFingerGestures, uint8_t multiFingerGestures)
+{
+    this->_singleGestures = singleFingerGestures;
+    this->_multiGestures = multiFingerGestures;
+}
+
+uint64_t IQS5xxEmulator::_reportPeriodMicros()
+{
+    return (uint64_t)this->peekWord(EMU_REG_ACTIVE_REPORT_RATE) * 1000;
+}
+
+uint64_t IQS5xxEmulator::_timeoutMicros()
+{
+    return (uint64_t)this->peek(EMU_REG_I2C_TIMEOUT) * 1000;
+}
+
+void IQS5xxEmulator::_publishFrame(uint64_t now)
+{
+    uint64_t cycle = now - this->_lastCycleStartAt;
+    if (this->_stats.windows == 0)
+    {
+        cycle = 0;
+    }
+    this->poke(EMU_REG_PREVIOUS_CYCLE_TIME, cycle / 1000 > 255 ? 255 : (uint8_t)(cycle / 1000));
+    this->_lastCycleStartAt = now;
+
+    int maxFingers = this->peek(EMU_REG_MAX_MULTI_TOUCHES);
+    if (maxFingers > IQS5XX_EMULATOR_NUM_FINGERS)
+    {
+        maxFingers = IQS5XX_EMULATOR_NUM_FINGERS;
+    }
+    bool tooMany = this->_numTouches > maxFingers;
+    int reported = tooMany ? maxFingers : this->_numTouches;
+
+    uint8_t systemInfo1 = this->_extraSystemInfo1;
+    if (reported > 0)               { systemInfo1 |= 1 << 0; } // TP_MOVEMENT
+    if (tooMany)                    { systemInfo1 |= 1 << 2; } // TOO_MANY_FINGERS
+    if (this->_reportMissed)        { systemInfo1 |= 1 << 3; } // RR_MISSED
+    this->_reportMissed = false;
+
+    this->poke(EMU_REG_SINGLE_FINGER_GESTURES, this->_singleGestures);
+    this->poke(EMU_REG_MULTI_FINGER_GESTURES, this->_multiGestures);
+    this->poke(EMU_REG_SYSTEM_INFO_0, this->_showReset ? EMU_SHOW_RESET : 0);
+    this->poke(EMU_REG_SYSTEM_INFO_1, systemInfo1);
+    this->poke(EMU_REG_NUM_FINGERS, (uint8_t)reported);
+
+    // relative movement is only reported for the first finger
+    int16_t relativeX = 0;
+    int16_t relativeY = 0;
+    if (reported > 0 && this->_previousFirstValid)
+    {
+        relativeX = (int16_t)(this->_touches[0].x - this->_previousFirst.x);
+        relativeY = (int16_t)(this->_touches[0].y - this->_previousFirst.y);
+    }
+    this->pokeWord(EMU_REG_RELATIVE_X, (uint16_t)relativeX);
+    this->pokeWord(EMU_REG_RELATIVE_Y, (uint16_t)relativeY);
+    this->_previousFirstValid = reported > 0;
+    this->_previousFirst = this->_touches[0];
+
+    for (int i = 0; i < IQS5XX_EMULATOR_NUM_FINGERS; i++)
+    {
+        uint16_t base = EMU_REG_FINGER_DATA + EMU_FINGER_DATA_SIZE * i;
+        IQS5xxEmulatorTouch touch = i < reported ? this->_touches[i] : IQS5xxEmulatorTouch();
+        this->pokeWord(base + 0, touch.x);
+        this->pokeWord(base + 2, touch.y);
+        this->pokeWord(base + 4, touch.strength);
+        this->poke(base + 6, touch.area);
+    }
+}
+
+void IQS5xxEmulator::_openWindow(uint64_t now)
+{
+    this->_publishFrame(now);
+
+    // reads without an address phase start at the default read address
+    this->_pointer = this->peekWord(EMU_REG_DEFAULT_READ_ADDRESS);
+
+    this->_windowOpen = true;
+    this->_endWindowPending = false;
+    this->_windowOpenedAt = now;
+    this->_lastActivityAt = now;
+    this->_nextReportAt = UINT64_MAX;
+    this->_stats.windows++;
+
+    HostArduino::drivePin(this->_PIN_RDY, HIGH);
+}
+
+void IQS5xxEmulator::_closeWindow(uint64_t now, bool timedOut)
+{
+    this->_windowOpen = false;
+    this->_endWindowPending = false;
+    this->_stats.windowOpenMicros += now - this->_windowOpenedAt;
+    if (timedOut)
+    {
+        this->_stats.timeouts++;
+    }
+
+    // gestures are one-shot
+    this->_singleGestures = 0;
+    this->_multiGestures = 0;
+
+    uint64_t due = this->_lastCycleStartAt + this->_reportPeriodMicros();
+    uint64_t earliest = now + EMU_MIN_PROCESSING_MICROS;
+    if (due < earliest)
+    {
+        this->_reportMissed = true;
+        this->_stats.missedReports++;
+        due = earliest;
+    }
+    this->_nextReportAt = due;
+
+    HostArduino::drivePin(this->_PIN_RDY, LOW);
+}
+
+bool IQS5xxEmulator::onWrite(const uint8_t* data, size_t len, bool stop)
+{
+    if (!this->_windowOpen || this->_inReset)
+    {
+        this->_stats.nacks++;
+        return false;
+    }
+
+    this->_stats.transactions++;
+    this->_stats.bytesWritten += len;
+    this->_lastActivityAt = HostArduino::nowMicros();
+
+    if (len >= 2)
+    {
+        this->_pointer = (uint16_t)((data[0] << 8) | data[1]);
+        for (size_t i = 2; i < len; i++)
+        {
+            if (this->_pointer == EMU_REG_END_COMMUNICATION)
+            {
+                this->_endWindowPending = true;
+                break;
+            }
+            if (this->_pointer == EMU_REG_SYSTEM_CONTROL_0 && (data[i] & EMU_ACK_RESET))
+            {
+                // ACK_RESET clears SHOW_RESET and is not kept
+                this->_showReset = false;
+                this->_memory[this->_pointer++] = data[i] & ~EMU_ACK_RESET;
+                continue;
+            }
+            this->_memory[this->_pointer++] = data[i];
+        }
+    }
+
+    if (stop && this->_endWindowPending)
+    {
+        this->_closeWindow(HostArduino::nowMicros(), false);
+    }
+
+    return true;
+}
+
+int IQS5xxEmulator::onRead(uint8_t* buf, size_t len, bool)
+{
+    if (!this->_windowOpen || this->_inReset)
+    {
+        this->_stats.nacks++;
+        return -1;
+    }
+
+    this->_stats.transactions++;
+    this->_stats.bytesRead += len;
+    this->_lastActivityAt = HostArduino::nowMicros();
+
+    for (size_t i = 0; i < len; i++)
+    {
+        buf[i] = this->_memory[this->_pointer++];
+    }
+    return (int)len;
+}
+
+void IQS5xxEmulator::onPinWritten(int pin, int value)
+{
+    if (pin != this->_PIN_RST)
+    {
+        return;
+    }
+
+    uint64_t now = HostArduino::nowMicros();
+    if (value == LOW && !this->_inReset)
+    {
+        this->_inReset = true;
+        this->_windowOpen = false;
+        this->_bootAt = UINT64_MAX;
+        this->_nextReportAt = UINT64_MAX;
+        HostArduino::drivePin(this->_PIN_RDY, LOW);
+    }
+    else if (value == HIGH && this->_inReset)
+    {
+        this->_inReset = false;
+        this->_loadDefaults();
+        this->_numTouches = 0;
+        this->_previousFirstValid = false;
+        this->_reportMissed = false;
+        this->_bootAt = now + this->_bootMicros;
+    }
+}
+
+void IQS5xxEmulator::resetSelf()
+{
+    this->onPinWritten(this->_PIN_RST, LOW);
+    this->onPinWritten(this->_PIN_RST, HIGH);
+}
+
+uint64_t IQS5xxEmulator::nextEventMicros()
+{
+    if (this->_inReset)
+    {
+        return UINT64_MAX;
+    }
+    if (this->_windowOpen)
+    {
+        uint64_t timeout = this->_timeoutMicros();
+        return timeout == 0 ? UINT64_MAX : this->_lastActivityAt + timeout;
+    }
+    return this->_bootAt < this->_nextReportAt ? this->_bootAt : this->_nextReportAt;
+}
+
+void IQS5xxEmulator::onTimeAdvanced(uint64_t now_us)
+{
+    if (this->_inReset)
+    {
+        return;
+    }
+
+    if (this->_bootAt <= now_us)
+    {
+        this->_bootAt = UINT64_MAX;
+        this->_nextReportAt = now_us;
+    }
+
+    if (!this->_windowOpen && this->_nextReportAt <= now_us)
+    {
+        this->_openWindow(now_us);
+    }
+    else if (this->_windowOpen)
+    {
+        uint64_t timeout = this->_timeoutMicros();
+        if (timeout != 0 && now_us - this->_lastActivityAt >= timeout)
+        {
+            this->_closeWindow(now_us, true);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef IQS5XX_EMULATOR_H
+#define IQS5XX_EMULATOR_H
+
+// behavioural model of an IQS5xx-B000 for host builds
+//
+// models what the driver depends on:
+// - the register map in IQSRegisters.h (16 bit addresses, big endian words)
+// - RDY going high once per report period to open a communication window,
+//   and low again when 0xEEEE is written or the I2C timeout (0x058A) expires
+// - an address pointer that starts at the default read address (0x0675) when
+//   the window opens and auto-increments on every byte read or written, so a
+//   read without an address phase continues from where the last one stopped
+// - RST holding the chip in reset, and settings returning to defaults on boot
+// - SHOW_RESET (system info 0 bit 7) set from boot until ACK_RESET (system
+//   control 0 bit 7) is written
+//
+// and does not model: sensing, filtering, gesture detection (gestures are
+// injected with setGestures), bootloader mode or the non-volatile settings
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <vector>
+
+#define IQS5XX_EMULATOR_NUM_FINGERS 5
+
+struct IQS5xxEmulatorTouch
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t strength;
+    uint8_t area;
+};
+
+struct IQS5xxEmulatorStats
+{
+    uint32_t windows = 0;          // communication windows opened
+    uint32_t timeouts = 0;         // windows closed by the I2C timeout
+    uint32_t missedReports = 0;    // cycles that could not start on time
+    uint32_t transactions = 0;     // I2C transactions addressed to the chip
+    uint32_t nacks = 0;            // transactions rejected outside a window
+    uint32_t bytesRead = 0;
+    uint32_t bytesWritten = 0;
+    uint64_t windowOpenMicros = 0; // total time RDY was high
+};
+
+class IQS5xxEmulator : public HostI2CDevice, public HostArduino::Peripheral
+{
+    private:
+        int _PIN_RDY;
+        int _PIN_RST;
+        uint8_t _i2cAddress;
+
+        std::vector<uint8_t> _memory;
+        uint16_t _pointer = 0;
+
+        bool _inReset = false;
+        bool _windowOpen = false;
+        uint64_t _bootAt = UINT64_MAX;
+        uint64_t _nextReportAt = UINT64_MAX;
+        uint64_t _windowOpenedAt = 0;
+        uint64_t _lastActivityAt = 0;
+        uint64_t _lastCycleStartAt = 0;
+        bool _endWindowPending = false;
+        bool _reportMissed = false;
+
+        IQS5xxEmulatorTouch _touches[IQS5XX_EMULATOR_NUM_FINGERS];
+        int _numTouches = 0;
+        IQS5xxEmulatorTouch _previousFirst;
+        bool _previousFirstValid = false;
+        uint8_t _singleGestures = 0;
+        uint8_t _multiGestures = 0;
+        uint8_t _extraSystemInfo1 = 0;
+        bool _showReset = false;
+
+        uint32_t _bootMicros = 2000;
+
+        IQS5xxEmulatorStats _stats;
+
+        void _loadDefaults();
+        void _openWindow(uint64_t now);
+        void _closeWindow(uint64_t now, bool timedOut);
+        void _publishFrame(uint64_t now);
+        uint64_t _reportPeriodMicros();
+        uint64_t _timeoutMicros();
+
+    public:
+        IQS5xxEmulator(int PIN_RDY, int PIN_RST, uint8_t i2cAddress = 0x74);
+        ~IQS5xxEmulator();
+
+        // register access, bypassing the bus
+        uint8_t peek(uint16_t address);
+        uint16_t peekWord(uint16_t address);
+        void poke(uint16_t address, uint8_t value);
+        void pokeWord(uint16_t address, uint16_t value);
+
+        // touch input for the following windows (at most 5 fingers are
+        // reported, more sets TOO_MANY_FINGERS)
+        void setTouches(const IQS5xxEmulatorTouch* touches, int numTouches);
+        void clearTouches() { setTouches(nullptr, 0); }
+        // one-shot gesture bits, reported in the next window only
+        void setGestures(uint8_t singleFingerGestures, uint8_t multiFingerGestures);
+        // additional bits OR'ed into system info 1 (e.g. SWITCH_STATE)
+        void setSystemInfo1Flags(uint8_t flags) { _extraSystemInfo1 = flags; }
+
+        // time from RST release to the first window
+        void setBootMicros(uint32_t us) { _bootMicros = us; }
+        // the chip resets itself (watchdog, brown-out), as if RST was pulsed
+        void resetSelf();
+
+        bool windowOpen() { return _windowOpen; }
+        const IQS5xxEmulatorStats& stats() { return _stats; }
+        void resetStats() { _stats = IQS5xxEmulatorStats(); }
+
+        // HostI2CDevice
+        uint8_t i2cAddress() override { return _i2cAddress; }
+        bool onWrite(const uint8_t* data, size_t len, bool stop) override;
+        int onRead(uint8_t* buf, size_t len, bool stop) override;
+
+        // HostArduino::Peripheral
+        void onTimeAdvanced(uint64_t now_us) override;
+        void onPinWritten(int pin, int value) override;
+        uint64_t nextEventMicros() override;
+};
+
+#endif // IQS5XX_EMULATOR_H
@@ -0,0 +1,46 @@
+#include "IQSHostBus.h"
+#include "I2CHelpers.h"
+#include <Wire.h>
+
+IQSHostBusBackend::IQSHostBusBackend(uint32_t latencyMicros)
+{
+    this->_latencyMicros = latencyMicros;
+}
+
+bool IQSHostBusBackend::submit(IQSTransaction& transaction)
+{
+    if (this->_current != nullptr)
+    {
+        return false;
+    }
+
+    transaction.done = false;
+
+    uint64_t busBefore = Wire.stats().busMicros;
+    Wire.setChargeBusTime(false);
+    transaction.error = I2CHelpers::transfer(transaction.i2cAddress, transaction.tx, transaction.txLength, transaction.rx, transaction.rxLength);
+    Wire.setChargeBusTime(true);
+
+    this->_current = &transaction;
+    this->_doneAt = HostArduino::nowMicros() + (Wire.stats().busMicros - busBefore) + this->_latencyMicros;
+    return true;
+}
+
+void IQSHostBusBackend::poll()
+{
+    if (this->_current != nullptr && HostArduino::nowMicros() >= this->_doneAt)
+    {
+        this->_current->done = true;
+        this->_current = nullptr;
+    }
+}
+
+void IQSHostBusBackend::abort(IQSTransaction& transaction)
+{
+    if (this->_current == &transaction)
+    {
+        this->_current = nullptr;
+        transaction.error = 5;
+        transaction.done = true;
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef IQS_HOST_BUS_H
+#define IQS_HOST_BUS_H
+
+// non-blocking bus backend for the host build, standing in for a DMA or
+// interrupt driven I2C peripheral
+//
+// submit() performs the transaction on the emulated bus straight away but
+// without charging its bus time to the clock; the transaction is only
+// reported done once that bus time plus a fixed latency (interrupt and
+// driver overhead) has passed on the virtual clock. time spent inside
+// update() therefore measures the CPU cost of a window, not the bus
+
+#include "IQSBus.h"
+
+class IQSHostBusBackend : public IQSBusBackend
+{
+    private:
+        uint32_t _latencyMicros;
+        IQSTransaction* _current = nullptr;
+        uint64_t _doneAt = 0;
+
+    public:
+        IQSHostBusBackend(uint32_t latencyMicros = 0);
+
+        void setLatency(uint32_t latencyMicros) { _latencyMicros = latencyMicros; }
+
+        bool submit(IQSTransaction& transaction) override;
+        void poll() override;
+        void abort(IQSTransaction& transaction) override;
+
+        // virtual time at which the transaction in flight completes, 0 if idle
+        uint64_t doneAt() { return _current != nullptr ? _doneAt : 0; }
+};
+
+#endif // IQS_HOST_BUS_H
@@ -0,0 +1,174 @@
+#include "Wire.h"
+#include <algorithm>
+
+TwoWire Wire;
+
+namespace
+{
+    // transactions reach the emulated devices, which the clock also drives,
+    // so they run under the host lock when an acquisition thread is used
+    struct BusLock
+    {
+        BusLock() { HostArduino::lock(); }
+        ~BusLock() { HostArduino::unlock(); }
+    };
+}
+
+HostI2CDevice* TwoWire::_find(uint8_t address)
+{
+    for (size_t i = 0; i < this->_devices.size(); i++)
+    {
+        if (this->_devices[i]->i2cAddress() == address)
+        {
+            return this->_devices[i];
+        }
+    }
+    return nullptr;
+}
+
+void TwoWire::_spendBusTime(size_t bytes)
+{
+    // start + address byte + data bytes, 9 clocks per byte (8 data + ack),
+    // plus roughly one more bit time for the stop/repeated start
+    uint64_t bits = 1 + 9 * (1 + bytes) + 1;
+    uint64_t us = (bits * 1000000 + this->_clock - 1) / this->_clock;
+    this->_stats.busMicros += us;
+    if (this->_chargeBusTime)
+    {
+        HostArduino::advanceMicros(us);
+    }
+}
+
+void TwoWire::attach(HostI2CDevice* device)
+{
+    this->_devices.push_back(device);
+}
+
+void TwoWire::detach(HostI2CDevice* device)
+{
+    this->_devices.erase(std::remove(this->_devices.begin(), this->_devices.end(), device), this->_devices.end());
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    this->_txAddress = address;
+    this->_txLength = 0;
+    this->_txOverflow = false;
+    this->_transmitting = true;
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+    if (!this->_transmitting)
+    {
+        return 0;
+    }
+    if (this->_txLength >= I2C_BUFFER_LENGTH)
+    {
+        this->_txOverflow = true;
+        return 0;
+    }
+    this->_txBuffer[this->_txLength++] = value;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity)
+{
+    for (size_t i = 0; i < quantity; i++)
+    {
+        if (!this->write(data[i]))
+        {
+            return i;
+        }
+    }
+    return quantity;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    BusLock lock;
+    this->_transmitting = false;
+
+    // same return codes as the Arduino cores:
+    // 1 = data too long, 2 = address NACK, 3 = data NACK
+    if (this->_txOverflow)
+    {
+        return 1;
+    }
+
+    this->_stats.transactions++;
+    this->_stats.bytesWritten += this->_txLength;
+
+    HostI2CDevice* device = this->_find(this->_txAddress);
+    if (device == nullptr)
+    {
+        this->_stats.nacks++;
+        this->_spendBusTime(0);
+        return 2;
+    }
+
+    bool ack = device->onWrite(this->_txBuffer, this->_txLength, sendStop);
+    this->_spendBusTime(ack ? this->_txLength : 0);
+    if (!ack)
+    {
+        this->_stats.nacks++;
+        return 2;
+    }
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(int address, int quantity, bool sendStop)
+{
+    BusLock lock;
+    this->_rxLength = 0;
+    this->_rxIndex = 0;
+
+    // like most cores, silently clamp to the receive buffer
+    if (quantity < 0)
+    {
+        quantity = 0;
+    }
+    if (quantity > I2C_BUFFER_LENGTH)
+    {
+        quantity = I2C_BUFFER_LENGTH;
+    }
+
+    this->_stats.transactions++;
+
+    HostI2CDevice* device = this->_find((uint8_t)address);
+    int received = device == nullptr ? -1 : device->onRead(this->_rxBuffer, (size_t)quantity, sendStop);
+    if (received < 0)
+    {
+        this->_stats.nacks++;
+        this->_spendBusTime(0);
+        return 0;
+    }
+
+    this->_rxLength = (size_t)received;
+    this->_stats.bytesRead += this->_rxLength;
+    this->_spendBusTime(this->_rxLength);
+    return (uint8_t)this->_rxLength;
+}
+
+int TwoWire::available()
+{
+    return (int)(this->_rxLength - this->_rxIndex);
+}
+
+int TwoWire::read()
+{
+    if (this->_rxIndex >= this->_rxLength)
+    {
+        return -1;
+    }
+    return this->_rxBuffer[this->_rxIndex++];
+}
+
+int TwoWire::peek()
+{
+    if (this->_rxIndex >= this->_rxLength)
+    {
+        return -1;
+    }
+    return this->_rxBuffer[this->_rxIndex];
+}
@@ -0,0 +1,88 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+// minimal stand-in for the Arduino Wire library, routing transactions to
+// emulated devices attached with Wire.attach() (see extras/host/README.md)
+
+#include "Arduino.h"
+#include <vector>
+
+#ifndef I2C_BUFFER_LENGTH
+#define I2C_BUFFER_LENGTH 128
+#endif
+
+// an emulated I2C target
+class HostI2CDevice
+{
+    public:
+        virtual ~HostI2CDevice() {}
+        virtual uint8_t i2cAddress() = 0;
+        // master wrote len bytes (possibly 0). return false to NACK
+        virtual bool onWrite(const uint8_t* data, size_t len, bool stop) = 0;
+        // master requested len bytes. return the number supplied, or -1 to NACK
+        virtual int onRead(uint8_t* buf, size_t len, bool stop) = 0;
+};
+
+// bus traffic counters, reset with Wire.resetStats()
+struct HostI2CStats
+{
+    uint32_t transactions = 0;
+    uint32_t bytesWritten = 0;
+    uint32_t bytesRead = 0;
+    uint32_t nacks = 0;
+    uint64_t busMicros = 0;
+};
+
+class TwoWire
+{
+    private:
+        std::vector<HostI2CDevice*> _devices;
+        uint32_t _clock = 100000;
+
+        uint8_t _txAddress = 0;
+        uint8_t _txBuffer[I2C_BUFFER_LENGTH];
+        size_t _txLength = 0;
+        bool _txOverflow = false;
+        bool _transmitting = false;
+
+        uint8_t _rxBuffer[I2C_BUFFER_LENGTH];
+        size_t _rxLength = 0;
+        size_t _rxIndex = 0;
+
+        HostI2CStats _stats;
+        bool _chargeBusTime = true;
+
+        HostI2CDevice* _find(uint8_t address);
+        void _spendBusTime(size_t bytes);
+
+    public:
+        void begin() {}
+        void end() {}
+        void setClock(uint32_t frequency) { _clock = frequency; }
+        uint32_t getClock() { return _clock; }
+
+        void beginTransmission(uint8_t address);
+        void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+        uint8_t endTransmission(bool sendStop = true);
+        size_t write(uint8_t value);
+        size_t write(const uint8_t* data, size_t quantity);
+
+        uint8_t requestFrom(int address, int quantity, bool sendStop = true);
+        int available();
+        int read();
+        int peek();
+
+        // host only
+        void attach(HostI2CDevice* device);
+        void detach(HostI2CDevice* device);
+        const HostI2CStats& stats() { return _stats; }
+        void resetStats() { _stats = HostI2CStats(); }
+        // when false, bus time is still counted in stats() but no longer
+        // advances the clock (for backends that model the transfer as
+        // running in the background, see IQSHostBus.h)
+        void setChargeBusTime(bool charge) { _chargeBusTime = charge; }
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
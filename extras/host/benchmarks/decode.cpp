@@ -0,0 +1,172 @@
+// benchmark of the frame block decoder: IQSDecode::frame() against the
+// decode it replaced (a getBit() call per flag and a running index into the
+// block), on frame blocks recorded from the emulator with 0 to 5 fingers.
+// also times the whole window, decode, filter and event path per frame by
+// replaying the recording through IQSReplay
+
+#include "IQSTouchpad.h"
+#include "IQS5xxEmulator.h"
+#include "I2CHelpers.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// keeps the capture in memory
+struct CaptureBuffer : Print
+{
+    std::vector<byte> data;
+    size_t write(uint8_t b) override { data.push_back(b); return 1; }
+};
+
+// what the old decoder produced, flags as separate bools
+struct OldFrame
+{
+    bool flags[15];
+    byte numFingers;
+    int x[5];
+    int y[5];
+    int strength[5];
+    int area[5];
+};
+
+// the decoder before IQSDecode, with its word reads sequenced
+static void oldDecode(const byte* block, OldFrame& out)
+{
+    int index = 0;
+    byte single = block[index++];
+    for (int i = 0; i < 6; i++) { out.flags[i] = I2CHelpers::getBit(single, i); }
+    byte multi = block[index++];
+    for (int i = 0; i < 3; i++) { out.flags[6 + i] = I2CHelpers::getBit(multi, i); }
+    index++;
+    byte info1 = block[index++];
+    for (int i = 0; i < 6; i++) { out.flags[9 + i] = I2CHelpers::getBit(info1, i); }
+    out.numFingers = block[index++];
+
+    int count = out.numFingers < 5 ? out.numFingers : 5;
+    count = out.flags[11] ? 0 : count;
+    index += 4;
+    for (int i = 0; i < 5; i++)
+    {
+        if (i >= count)
+        {
+            out.x[i] = out.y[i] = out.strength[i] = out.area[i] = 0;
+            continue;
+        }
+        int high = block[index++];
+        out.x[i] = (high << 8) | block[index++];
+        high = block[index++];
+        out.y[i] = (high << 8) | block[index++];
+        high = block[index++];
+        out.strength[i] = (high << 8) | block[index++];
+        out.area[i] = block[index++];
+    }
+}
+
+int main()
+{
+    // record a capture: every finger count for a while, each moving
+    IQS5xxEmulator chip(4, 5);
+    IQSTouchpad touchpad(4, 5, 3072, 2048);
+    touchpad.begin(400000);
+    CaptureBuffer buffer;
+    IQSCaptureWriter capture(buffer);
+    touchpad.setCapture(&capture);
+    for (int i = 0; i < 40000; i++)
+    {
+        IQS5xxEmulatorTouch touches[5];
+        for (int f = 0; f < 5; f++)
+        {
+            touches[f] = {(uint16_t)(200 + f * 500 + i % 300), (uint16_t)(300 + f * 300 + i % 200), (uint16_t)(40 + f), 3};
+        }
+        chip.setTouches(touches, (i / 700) % 6);
+        touchpad.update();
+        HostArduino::advanceMicros(250);
+    }
+    capture.flush();
+
+    std::vector<std::vector<byte>> blocks;
+    IQSCaptureReader reader(buffer.data.data(), buffer.data.size());
+    int record;
+    while ((record = reader.next()) != CAPTURE_END && record != CAPTURE_ERROR)
+    {
+        if (record == CAPTURE_FRAME)
+        {
+            // the old decoder assumed all five slots were read
+            std::vector<byte> block(reader.frame(), reader.frame() + reader.frameLength());
+            block.resize(9 + 7 * 5);
+            blocks.push_back(block);
+        }
+    }
+
+    // both decoders agree on every recorded frame
+    int wrong = 0;
+    for (const std::vector<byte>& block : blocks)
+    {
+        OldFrame before;
+        IQSRawFrame after;
+        oldDecode(block.data(), before);
+        IQSDecode::frame(block.data(), (int)block.size(), after);
+        wrong += before.numFingers != after.numFingers;
+        for (int i = 0; i < 5; i++)
+        {
+            wrong += before.x[i] != after.x[i] || before.y[i] != after.y[i];
+            wrong += before.strength[i] != after.strength[i] || before.area[i] != after.area[i];
+        }
+    }
+    if (blocks.empty() || wrong != 0)
+    {
+        printf("decode: %zu frames, %d mismatches\n", blocks.size(), wrong);
+        return 1;
+    }
+
+    volatile uint32_t sink = 0;
+    double best[2] = {1e30, 1e30};
+    for (int attempt = 0; attempt < 5; attempt++)
+    {
+        for (int decoder = 0; decoder < 2; decoder++)
+        {
+            OldFrame before;
+            IQSRawFrame after;
+            auto start = std::chrono::steady_clock::now();
+            for (int round = 0; round < 500; round++)
+            {
+                for (const std::vector<byte>& block : blocks)
+                {
+                    if (decoder == 0)
+                    {
+                        oldDecode(block.data(), before);
+                        sink = sink + before.x[0] + before.y[4] + before.flags[3];
+                    }
+                    else
+                    {
+                        IQSDecode::frame(block.data(), (int)block.size(), after);
+                        sink = sink + after.x[0] + after.y[4] + after.gestures;
+                    }
+                }
+            }
+            double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (500.0 * blocks.size());
+            best[decoder] = nanos < best[decoder] ? nanos : best[decoder];
+        }
+    }
+
+    double replay = 1e30;
+    for (int attempt = 0; attempt < 5; attempt++)
+    {
+        IQSCaptureReader replayReader(buffer.data.data(), buffer.data.size());
+        IQSReplay replayBus(replayReader);
+        IQSTouchpad replayed(4, 5, 3072, 2048);
+        size_t frames = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (replayBus.step(replayed))
+        {
+            frames += replayed.wasUpdated;
+        }
+        double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+        replay = nanos < replay ? nanos : replay;
+    }
+
+    printf("%zu recorded frames, ns per frame (best of 5)\n", blocks.size());
+    printf("  decode: before %5.1f   IQSDecode::frame %5.1f\n", best[0], best[1]);
+    printf("  replay through IQSTouchpad: %.0f\n", replay);
+    return 0;
+}
@@ -0,0 +1,143 @@
+// benchmark of the fixed-point IQSAxisFilter against a float reference of
+// the same filter (1 euro jitter stage plus velocity/acceleration
+// prediction): cost per sample, and how far the fixed-point output strays
+// from the float one over a noisy trajectory of still, slow and fast motion
+
+#include "IQSFilter.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// the float filter the fixed-point one is modelled on
+class FloatAxisFilter
+{
+    private:
+        bool _primed = false;
+        float _position = 0;
+        float _speed = 0;
+        float _velocity = 0;
+        float _acceleration = 0;
+
+        static float alpha(float cutoff, float dt)
+        {
+            float r = 2 * (float)M_PI * cutoff * dt;
+            return r / (1 + r);
+        }
+
+    public:
+        int apply(const IQSFilterConfig& config, int value, uint32_t dtMicros)
+        {
+            float sample = (float)value;
+            if (!this->_primed || dtMicros == 0 || dtMicros > 200000)
+            {
+                this->_primed = true;
+                this->_position = sample;
+                this->_speed = 0;
+                this->_velocity = 0;
+                this->_acceleration = 0;
+                return value;
+            }
+
+            float dt = dtMicros / 1e6f;
+            float previous = this->_position;
+            float derivativeAlpha = alpha(config.derivativeCutoff / 1000.0f, dt);
+
+            if (config.stages & IQS_FILTER_JITTER)
+            {
+                float speed = (sample - previous) / dt;
+                this->_speed += (speed - this->_speed) * derivativeAlpha;
+                float cutoff = config.minCutoff / 1000.0f + config.beta / 65536.0f * fabsf(this->_speed);
+                if (cutoff > 1000) { cutoff = 1000; }
+                this->_position += (sample - previous) * alpha(cutoff, dt);
+            }
+            else
+            {
+                this->_position = sample;
+            }
+
+            float output = this->_position;
+            if (config.stages & IQS_FILTER_PREDICT)
+            {
+                float velocity = (this->_position - previous) / dt;
+                float acceleration = (velocity - this->_velocity) / dt;
+                this->_velocity += (velocity - this->_velocity) * derivativeAlpha;
+                this->_acceleration += (acceleration - this->_acceleration) * derivativeAlpha;
+                float lead = (config.leadMicros < 1000000 ? config.leadMicros : 1000000) / 1e6f;
+                output += this->_velocity * lead + this->_acceleration * lead * lead / 2;
+            }
+
+            output = floorf(output + 0.5f);
+            return output < 0 ? 0 : (int)output;
+        }
+};
+
+// a finger resting, then moving slowly, then flicking, at a 5 ms report
+// period with +-2 px of noise
+static std::vector<int> trajectory(int samples)
+{
+    std::vector<int> values;
+    srand(1);
+    double position = 1000;
+    for (int i = 0; i < samples; i++)
+    {
+        int phase = (i / 200) % 3;
+        position += phase == 0 ? 0 : phase == 1 ? 0.5 : 8 * sin(i * 0.05);
+        values.push_back((int)position + rand() % 5 - 2);
+    }
+    return values;
+}
+
+template <typename Filter>
+static double nanosPerSample(const IQSFilterConfig& config, const std::vector<int>& values)
+{
+    double best = 1e30;
+    volatile int sink = 0;
+    for (int attempt = 0; attempt < 5; attempt++)
+    {
+        Filter filter;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < 100; round++)
+        {
+            for (int value : values)
+            {
+                sink = sink + filter.apply(config, value, 5000);
+            }
+        }
+        double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = nanos < best ? nanos : best;
+    }
+    return best / (100.0 * values.size());
+}
+
+int main()
+{
+    std::vector<int> values = trajectory(6000);
+    const char* names[] = {"jitter", "predict", "jitter + predict"};
+    uint8_t stages[] = {IQS_FILTER_JITTER, IQS_FILTER_PREDICT, IQS_FILTER_JITTER | IQS_FILTER_PREDICT};
+
+    printf("ns per sample (best of 5), and fixed-point output against float\n");
+    for (int s = 0; s < 3; s++)
+    {
+        IQSFilterConfig config;
+        config.stages = stages[s];
+
+        IQSAxisFilter fixed;
+        FloatAxisFilter reference;
+        int worst = 0;
+        long differing = 0;
+        for (int value : values)
+        {
+            int difference = abs(fixed.apply(config, value, 5000) - reference.apply(config, value, 5000));
+            worst = difference > worst ? difference : worst;
+            differing += difference != 0;
+        }
+
+        double fixedNanos = nanosPerSample<IQSAxisFilter>(config, values);
+        double floatNanos = nanosPerSample<FloatAxisFilter>(config, values);
+        printf("  %-16s fixed %5.1f   float %5.1f   max error %d px, %.1f%% of samples off\n",
+            names[s], fixedNanos, floatNanos, worst, 100.0 * differing / values.size());
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// benchmark of IQSRegisters::getRegister by address and by name over the
+// whole register map, against the lookups it replaced: an unordered_map
+// indexed with operator[] by address, and a linear scan comparing
+// std::strings by name (the original also allocated a new IQSRegister on a
+// miss, left out here). every lookup is checked to find the right register
+
+#include "IQSRegisters.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static const int ROUNDS = 20000;
+
+template <typename Lookup>
+static double nanosPerLookup(int lookups, Lookup lookup)
+{
+    double best = 1e30;
+    for (int attempt = 0; attempt < 5; attempt++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; round++)
+        {
+            lookup();
+        }
+        double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = nanos < best ? nanos : best;
+    }
+    return best / ((double)ROUNDS * lookups);
+}
+
+int main()
+{
+    const int size = IQSRegisterMap::size;
+    std::vector<int> addresses;
+    std::vector<std::string> names;
+    std::unordered_map<int, const IQSRegister*> byAddress;
+    for (int i = 0; i < size; i++)
+    {
+        const IQSRegister* reg = &IQSRegisterMap::registers[i];
+        addresses.push_back(reg->getAddress());
+        names.push_back(reg->getName());
+        byAddress[reg->getAddress()] = reg;
+    }
+
+    // every register is found, and found by both keys
+    int wrong = 0;
+    for (int i = 0; i < size; i++)
+    {
+        const IQSRegister* reg = &IQSRegisterMap::registers[i];
+        wrong += IQSRegisters::getRegister(addresses[i]) != reg;
+        wrong += IQSRegisters::getRegister(names[i].c_str()) != reg;
+    }
+    wrong += IQSRegisters::getRegister(0x1234) != nullptr;
+    wrong += IQSRegisters::getRegister("No Such Register") != nullptr;
+    if (wrong != 0)
+    {
+        printf("register_lookup: %d lookups wrong\n", wrong);
+        return 1;
+    }
+
+    volatile uintptr_t sink = 0;
+
+    double address = nanosPerLookup(size, [&]()
+    {
+        for (int a : addresses) { sink = sink + (uintptr_t)IQSRegisters::getRegister(a); }
+    });
+    double addressMap = nanosPerLookup(size, [&]()
+    {
+        for (int a : addresses) { sink = sink + (uintptr_t)byAddress[a]; }
+    });
+
+    double name = nanosPerLookup(size, [&]()
+    {
+        for (const std::string& n : names) { sink = sink + (uintptr_t)IQSRegisters::getRegister(n.c_str()); }
+    });
+    double nameScan = nanosPerLookup(size, [&]()
+    {
+        for (const std::string& n : names)
+        {
+            for (int i = 0; i < size; i++)
+            {
+                if (std::string(IQSRegisterMap::registers[i].getName()) == n)
+                {
+                    sink = sink + (uintptr_t)&IQSRegisterMap::registers[i];
+                    break;
+                }
+            }
+        }
+    });
+
+    printf("%d registers, ns per lookup (best of 5)\n", size);
+    printf("  by address: binary search %6.1f   unordered_map[] %6.1f\n", address, addressMap);
+    printf("  by name:    binary search %6.1f   linear scan     %6.1f\n", name, nameScan);
+    return 0;
+}
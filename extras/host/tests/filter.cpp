@@ -0,0 +1,113 @@
+// test of the coordinate filter's prediction at the edges of the pad
+//
+// a finger flicked toward the far edges is extrapolated past them by the
+// velocity and acceleration terms. the filtered coordinates, straight from
+// IQSAxisFilter and through the emulator and IQSTouchpad::update(), must
+// stay within the resolution. exits non-zero on failure
+
+#include "IQSTouchpad.h"
+#include "IQSFilter.h"
+#include "IQS5xxEmulator.h"
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(condition, ...) \
+    do { if (!(condition)) { failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+static void axis()
+{
+    IQSFilterConfig config;
+    config.stages = IQS_FILTER_JITTER | IQS_FILTER_PREDICT;
+    config.leadMicros = 50000;
+
+    // 150 px per 10 ms report toward the end of a 3072 px axis
+    IQSAxisFilter filter;
+    int highest = 0;
+    for (int x = 1500; x <= 3071; x += 150)
+    {
+        int out = filter.apply(config, x, 10000, 3072);
+        highest = out > highest ? out : highest;
+    }
+    int last = filter.apply(config, 3071, 10000, 3072);
+    CHECK(highest <= 3071, "flick to x = 3071: filtered up to %d", highest);
+    CHECK(last == 3071, "flick to x = 3071: ended at %d", last);
+
+    // and toward 0, which was always clamped
+    filter.reset();
+    int lowest = 3071;
+    for (int x = 1500; x >= 0; x -= 150)
+    {
+        int out = filter.apply(config, x, 10000, 3072);
+        lowest = out < lowest ? out : lowest;
+    }
+    CHECK(lowest == 0, "flick to x = 0: filtered down to %d", lowest);
+
+    // without a resolution only the chip's 16 bits bound it
+    filter.reset();
+    int unbounded = 0;
+    for (int x = 60000; x <= 65535; x += 500)
+    {
+        int out = filter.apply(config, x, 10000);
+        unbounded = out > unbounded ? out : unbounded;
+    }
+    CHECK(unbounded == 65535, "flick to 65535 without a resolution: filtered up to %d", unbounded);
+}
+
+static void touchpad()
+{
+    IQS5xxEmulator chip(4, 5);
+    IQSTouchpad touchpad(4, 5, 3072, 2048);
+    touchpad.begin(400000);
+    IQSFilterConfig config;
+    config.stages = IQS_FILTER_PREDICT;
+    config.leadMicros = 50000;
+    touchpad.setFilter(config);
+    for (int i = 0; i < 50; i++)
+    {
+        touchpad.update();
+        delay(1);
+    }
+    CHECK(touchpad.X_resolution == 3072 && touchpad.Y_resolution == 2048, "resolution %dx%d", touchpad.X_resolution, touchpad.Y_resolution);
+
+    // down and to the right, into the corner
+    int highestX = 0;
+    int highestY = 0;
+    int frames = 0;
+    for (int step = 0; step <= 12; step++)
+    {
+        int x = 1500 + step * 150;
+        int y = 900 + step * 100;
+        IQS5xxEmulatorTouch touch = { (uint16_t)(x < 3071 ? x : 3071), (uint16_t)(y < 2047 ? y : 2047), 100, 5 };
+        chip.setTouches(&touch, 1);
+        for (int i = 0; i < 100; i++)
+        {
+            touchpad.update();
+            if (touchpad.wasUpdated)
+            {
+                Finger finger = touchpad.getFinger(0);
+                highestX = finger.x > highestX ? finger.x : highestX;
+                highestY = finger.y > highestY ? finger.y : highestY;
+                frames++;
+                break;
+            }
+            delay(1);
+        }
+    }
+    CHECK(frames == 13, "%d of 13 frames decoded", frames);
+    CHECK(highestX <= 3071 && highestY <= 2047, "flick into the corner: fingers reached (%d, %d)", highestX, highestY);
+}
+
+int main()
+{
+    axis();
+    touchpad();
+
+    if (failures != 0)
+    {
+        printf("filter: %d failures\n", failures);
+        return 1;
+    }
+    printf("filter: passed\n");
+    return 0;
+}
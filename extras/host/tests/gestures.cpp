@@ -0,0 +1,304 @@
+// deterministic test of the software gesture recognizer (IQSGestures)
+//
+// scripted touches go through the emulated chip and IQSTouchpad::update(),
+// and every decoded frame (IQSTouchpad::lastFrame) through
+// IQSGestures::process(). the events raised are checked against what each
+// script should produce, and the fixed-point atan2/sqrt against libm.
+// exits non-zero on failure
+
+#include "IQSTouchpad.h"
+#include "IQSGestures.h"
+#include "IQS5xxEmulator.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition, ...) \
+    do { if (!(condition)) { failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+static const double PI = 3.14159265358979323846;
+
+struct Harness
+{
+    IQS5xxEmulator chip;
+    IQSTouchpad touchpad;
+    IQSGestures gestures;
+    std::vector<IQSGestureEvent> events;
+
+    Harness() : chip(4, 5), touchpad(4, 5, 3072, 2048)
+    {
+        touchpad.begin(400000);
+        // slots follow the fingers, as IQSGestures expects. no finger in
+        // these scripts moves 300 px between frames
+        touchpad.setFingerTracking(true, 300);
+        gestures.setEdges(3072, 2048, 64);
+        // settle: configuration written, frames flowing
+        for (int i = 0; i < 50; i++)
+        {
+            touchpad.update();
+            delay(1);
+        }
+        gestures.reset();
+    }
+
+    // one report window with these touches
+    void frame(const IQS5xxEmulatorTouch* touches, int count)
+    {
+        chip.setTouches(touches, count);
+        for (int i = 0; i < 100; i++)
+        {
+            touchpad.update();
+            if (touchpad.wasUpdated)
+            {
+                int raised = gestures.process(touchpad.lastFrame);
+                for (int e = 0; e < raised; e++)
+                {
+                    events.push_back(gestures.events()[e]);
+                }
+                return;
+            }
+            delay(1);
+        }
+        failures++;
+        printf("FAIL: no frame decoded\n");
+    }
+
+    void lift()
+    {
+        frame(nullptr, 0);
+        frame(nullptr, 0);
+    }
+
+    int count(uint8_t type, uint8_t phase)
+    {
+        int n = 0;
+        for (const IQSGestureEvent& event : events)
+        {
+            n += event.type == type && event.phase == phase;
+        }
+        return n;
+    }
+
+    const IQSGestureEvent* last(uint8_t type, uint8_t phase)
+    {
+        for (int i = (int)events.size() - 1; i >= 0; i--)
+        {
+            if (events[i].type == type && events[i].phase == phase)
+            {
+                return &events[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+static IQS5xxEmulatorTouch touch(double x, double y)
+{
+    return IQS5xxEmulatorTouch { (uint16_t)lround(x), (uint16_t)lround(y), 100, 5 };
+}
+
+// fingers spaced along y, moved together by (dx, dy) over steps frames
+static void multiSwipe(int fingers, int dx, int dy, int expectedDirection)
+{
+    Harness h;
+    for (int step = 0; step <= 20; step++)
+    {
+        IQS5xxEmulatorTouch touches[5];
+        for (int f = 0; f < fingers; f++)
+        {
+            touches[f] = touch(1000 + dx * step / 20.0 + f * 150, 1000 + dy * step / 20.0 + f * 40);
+        }
+        h.frame(touches, fingers);
+    }
+    h.lift();
+
+    CHECK(h.count(GESTURE_SWIPE, GESTURE_END) == 1, "%d-finger swipe: %d swipes", fingers, h.count(GESTURE_SWIPE, GESTURE_END));
+    const IQSGestureEvent* swipe = h.last(GESTURE_SWIPE, GESTURE_END);
+    if (swipe != nullptr)
+    {
+        CHECK(swipe->fingers == fingers, "%d-finger swipe: reported %d fingers", fingers, swipe->fingers);
+        CHECK(swipe->direction == expectedDirection, "%d-finger swipe: direction %d, expected %d", fingers, swipe->direction, expectedDirection);
+    }
+    CHECK(h.count(GESTURE_PINCH, GESTURE_BEGIN) == 0 && h.count(GESTURE_ROTATE, GESTURE_BEGIN) == 0, "%d-finger swipe: also pinched or rotated", fingers);
+}
+
+// two fingers about a centre: radius from r0 to r1 and angle from 0 to turn
+static Harness* twoFinger(double r0, double r1, double turn)
+{
+    Harness* h = new Harness();
+    for (int step = 0; step <= 40; step++)
+    {
+        double t = step / 40.0;
+        double r = r0 + (r1 - r0) * t;
+        double a = 2 * PI * turn * t;
+        IQS5xxEmulatorTouch touches[2] = {
+            touch(1500 + r * cos(a), 1000 + r * sin(a)),
+            touch(1500 - r * cos(a), 1000 - r * sin(a)),
+        };
+        h->frame(touches, 2);
+    }
+    h->lift();
+    return h;
+}
+
+static void pinch()
+{
+    Harness* h = twoFinger(200, 400, 0);
+    CHECK(h->count(GESTURE_PINCH, GESTURE_BEGIN) == 1, "pinch: %d begins", h->count(GESTURE_PINCH, GESTURE_BEGIN));
+    CHECK(h->count(GESTURE_PINCH, GESTURE_UPDATE) > 10, "pinch: %d updates", h->count(GESTURE_PINCH, GESTURE_UPDATE));
+    CHECK(h->count(GESTURE_PINCH, GESTURE_END) == 1, "pinch: %d ends", h->count(GESTURE_PINCH, GESTURE_END));
+    const IQSGestureEvent* begin = h->last(GESTURE_PINCH, GESTURE_BEGIN);
+    const IQSGestureEvent* end = h->last(GESTURE_PINCH, GESTURE_END);
+    if (begin != nullptr && end != nullptr)
+    {
+        // starts once the scale passes the default threshold of 1 + 1/8
+        CHECK(begin->value >= 65536 + 65536 / 8 && begin->value < 65536 * 13 / 10, "pinch: began at scale %d", begin->value);
+        CHECK(labs(end->value - 2 * 65536) < 65536 / 100, "pinch: ended at scale %d, expected 131072", end->value);
+    }
+    CHECK(h->count(GESTURE_ROTATE, GESTURE_BEGIN) == 0, "pinch: also rotated");
+    CHECK(h->count(GESTURE_SWIPE, GESTURE_END) == 0, "pinch: also swiped");
+    delete h;
+
+    h = twoFinger(400, 200, 0);
+    const IQSGestureEvent* in = h->last(GESTURE_PINCH, GESTURE_END);
+    CHECK(in != nullptr && labs(in->value - 65536 / 2) < 65536 / 100, "pinch in: ended at scale %d, expected 32768", in ? in->value : 0);
+    delete h;
+}
+
+static void rotate()
+{
+    Harness* h = twoFinger(300, 300, 0.25);
+    CHECK(h->count(GESTURE_ROTATE, GESTURE_BEGIN) == 1, "rotate: %d begins", h->count(GESTURE_ROTATE, GESTURE_BEGIN));
+    CHECK(h->count(GESTURE_ROTATE, GESTURE_END) == 1, "rotate: %d ends", h->count(GESTURE_ROTATE, GESTURE_END));
+    const IQSGestureEvent* begin = h->last(GESTURE_ROTATE, GESTURE_BEGIN);
+    const IQSGestureEvent* end = h->last(GESTURE_ROTATE, GESTURE_END);
+    if (begin != nullptr && end != nullptr)
+    {
+        CHECK(begin->value >= 65536 / 24 && begin->value < 65536 / 12, "rotate: began at angle %d", begin->value);
+        // a quarter turn counter-clockwise
+        CHECK(labs(end->value - 16384) < 16384 / 50, "rotate: ended at angle %d, expected 16384", end->value);
+    }
+    CHECK(h->count(GESTURE_PINCH, GESTURE_BEGIN) == 0, "rotate: also pinched");
+    delete h;
+
+    h = twoFinger(300, 300, -0.125);
+    const IQSGestureEvent* clockwise = h->last(GESTURE_ROTATE, GESTURE_END);
+    CHECK(clockwise != nullptr && labs(clockwise->value + 8192) < 8192 / 50, "rotate clockwise: ended at angle %d, expected -8192", clockwise ? clockwise->value : 0);
+    delete h;
+}
+
+static void edgeSwipe(double startX, double startY, int dx, int dy, int expected)
+{
+    Harness h;
+    for (int step = 0; step <= 20; step++)
+    {
+        IQS5xxEmulatorTouch one = touch(startX + dx * step / 20.0, startY + dy * step / 20.0);
+        h.frame(&one, 1);
+    }
+    h.lift();
+
+    int swipes = h.count(GESTURE_EDGE_SWIPE, GESTURE_END);
+    if (expected == DIRECTION_NONE)
+    {
+        CHECK(swipes == 0, "swipe from (%.0f, %.0f): %d edge swipes, expected none", startX, startY, swipes);
+        return;
+    }
+    CHECK(swipes == 1, "edge swipe from (%.0f, %.0f): %d edge swipes", startX, startY, swipes);
+    const IQSGestureEvent* swipe = h.last(GESTURE_EDGE_SWIPE, GESTURE_END);
+    CHECK(swipe == nullptr || swipe->direction == expected, "edge swipe from (%.0f, %.0f): direction %d, expected %d", startX, startY, swipe ? swipe->direction : -1, expected);
+}
+
+static void stillFingers()
+{
+    // small jitter of resting fingers raises nothing
+    Harness h;
+    srand(1);
+    for (int step = 0; step < 60; step++)
+    {
+        IQS5xxEmulatorTouch touches[3];
+        for (int f = 0; f < 3; f++)
+        {
+            touches[f] = touch(800 + f * 300 + rand() % 9 - 4, 900 + rand() % 9 - 4);
+        }
+        h.frame(touches, 3);
+    }
+    h.lift();
+    CHECK(h.events.empty(), "resting fingers: %d events", (int)h.events.size());
+}
+
+static void fingerReplaced()
+{
+    // of three resting fingers, the first lifts and another lands elsewhere
+    // in the same frame. the chip packs the contacts into its first slots
+    // again, so pairing them by slot order alone would see them turn
+    Harness h;
+    IQS5xxEmulatorTouch before[3] = { touch(1000, 600), touch(1400, 1000), touch(1000, 1400) };
+    IQS5xxEmulatorTouch after[3] = { touch(1400, 1000), touch(1000, 1400), touch(600, 1000) };
+    for (int step = 0; step < 10; step++)
+    {
+        h.frame(before, 3);
+    }
+    for (int step = 0; step < 10; step++)
+    {
+        h.frame(after, 3);
+    }
+    h.lift();
+    CHECK(h.events.empty(), "finger replaced: %d events, first type %d", (int)h.events.size(), h.events.empty() ? -1 : h.events[0].type);
+}
+
+static void helpers()
+{
+    int worst = 0;
+    for (int i = 0; i < 3600; i++)
+    {
+        double a = 2 * PI * i / 3600.0;
+        int32_t x = (int32_t)lround(100000 * cos(a));
+        int32_t y = (int32_t)lround(100000 * sin(a));
+        double exact = std::atan2((double)y, (double)x) / (2 * PI) * 65536;
+        int error = abs((int)lround(exact) - IQSGestures::atan2(y, x));
+        // +-pi are the same angle
+        error = error > 32768 ? 65536 - error : error;
+        worst = error > worst ? error : worst;
+    }
+    CHECK(worst <= 1, "atan2: off by up to %d / 65536 turn", worst);
+
+    srand(2);
+    int wrong = 0;
+    for (int i = 0; i < 100000; i++)
+    {
+        uint64_t value = ((uint64_t)rand() << 31 ^ (uint64_t)rand()) >> (rand() % 40);
+        uint64_t root = IQSGestures::sqrt(value);
+        wrong += !(root * root <= value && (root + 1) * (root + 1) > value);
+    }
+    CHECK(wrong == 0, "sqrt: %d of 100000 not floor(sqrt)", wrong);
+}
+
+int main()
+{
+    multiSwipe(3, 600, 0, DIRECTION_X_POS);
+    multiSwipe(3, -600, 0, DIRECTION_X_NEG);
+    multiSwipe(4, 0, -500, DIRECTION_Y_NEG);
+    multiSwipe(5, 0, 500, DIRECTION_Y_POS);
+    pinch();
+    rotate();
+    edgeSwipe(20, 1000, 600, 0, DIRECTION_X_POS);
+    edgeSwipe(3050, 1000, -600, 0, DIRECTION_X_NEG);
+    edgeSwipe(1500, 2030, 0, -500, DIRECTION_Y_NEG);
+    edgeSwipe(1000, 1000, 600, 0, DIRECTION_NONE);
+    // from an edge, but along it rather than away
+    edgeSwipe(20, 500, 0, 600, DIRECTION_NONE);
+    stillFingers();
+    fingerReplaced();
+    helpers();
+
+    if (failures != 0)
+    {
+        printf("gestures: %d failures\n", failures);
+        return 1;
+    }
+    printf("gestures: passed\n");
+    return 0;
+}
@@ -0,0 +1,165 @@
+// stress test of the multi-producer request queues (IQSRing)
+//
+// several std::threads push while one consumer pops, first on a bare ring and
+// then through IQSTouchpad::queueRead() with update() as the consumer. every
+// item must arrive exactly once, and the items of each producer in the order
+// it pushed them. exits non-zero on failure
+
+#include "IQSTouchpad.h"
+#include "IQS5xxEmulator.h"
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition, ...) \
+    do { if (!(condition)) { failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+struct Item
+{
+    int producer;
+    int sequence;
+};
+
+static void ringStress(int producers, int itemsEach)
+{
+    IQSRing<Item, 64> ring;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&ring, p, itemsEach]()
+        {
+            for (int i = 0; i < itemsEach; i++)
+            {
+                // full: retry until the consumer has made room
+                while (!ring.push(Item { p, i }))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    int outOfOrder = 0;
+    while (received < producers * itemsEach)
+    {
+        Item item;
+        if (!ring.pop(item))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if (item.producer < 0 || item.producer >= producers || item.sequence != next[item.producer])
+        {
+            outOfOrder++;
+        }
+        else
+        {
+            next[item.producer]++;
+        }
+        received++;
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    Item extra;
+    CHECK(outOfOrder == 0, "ring: %d items lost, duplicated or out of order", outOfOrder);
+    CHECK(!ring.pop(extra), "ring: items left over after %d", received);
+    printf("ring: %d producers x %d items, %d received, %d out of order\n", producers, itemsEach, received, outOfOrder);
+}
+
+static void touchpadStress(int producers, int readsEach)
+{
+    IQS5xxEmulator chip(4, 5);
+    IQSTouchpad touchpad(4, 5, 1000, 800);
+    touchpad.begin(400000);
+
+    // completions per request, filled in by update() (or by a refused push)
+    std::vector<std::atomic<int>> completed(producers * readsEach);
+    for (std::atomic<int>& count : completed)
+    {
+        count = 0;
+    }
+    std::atomic<int> refused(0);
+    std::atomic<int> producersDone(0);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&, p]()
+        {
+            for (int i = 0; i < readsEach; i++)
+            {
+                int index = p * readsEach + i;
+                bool queued;
+                do
+                {
+                    queued = touchpad.queueRead(0x0000, 2, [&completed, &refused, index](int, int, byte error)
+                    {
+                        if (error == 10)
+                        {
+                            // queue full, the producer tries again
+                            refused++;
+                            return;
+                        }
+                        completed[index]++;
+                    });
+                    if (!queued)
+                    {
+                        std::this_thread::yield();
+                    }
+                } while (!queued);
+            }
+            producersDone++;
+        });
+    }
+
+    while (producersDone < producers || touchpad.windowInProgress())
+    {
+        touchpad.update();
+        delay(1);
+    }
+    // drain what was queued after the last window
+    for (int i = 0; i < 100; i++)
+    {
+        touchpad.update();
+        delay(1);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    int lost = 0;
+    int duplicated = 0;
+    for (std::atomic<int>& count : completed)
+    {
+        lost += count == 0;
+        duplicated += count > 1;
+    }
+    CHECK(lost == 0, "touchpad: %d reads never completed", lost);
+    CHECK(duplicated == 0, "touchpad: %d reads completed more than once", duplicated);
+    printf("touchpad: %d producers x %d reads, %d lost, %d duplicated, %d pushes refused (full)\n",
+        producers, readsEach, lost, duplicated, (int)refused);
+}
+
+int main()
+{
+    ringStress(4, 200000);
+    ringStress(8, 50000);
+    touchpadStress(3, 2000);
+
+    if (failures != 0)
+    {
+        printf("queue_stress: %d failures\n", failures);
+        return 1;
+    }
+    printf("queue_stress: passed\n");
+    return 0;
+}